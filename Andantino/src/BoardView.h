@@ -91,6 +91,13 @@ public:
 					if (state.isFreeSpot(selected.first, selected.second))
 					{
 						state.makeMove(selected.first, selected.second);
+
+						if (ponderControl && selected.first == ponderMove.x && selected.second == ponderMove.y)
+						{
+							searchControl = std::move(ponderControl);
+							searchControl->ponderHit();
+						}
+						ponderControl.reset();
 					}
 				}
 			}
@@ -101,6 +108,7 @@ public:
 		{
 			if (state.moves.size() > 1 && !searchControl)
 			{
+				ponderControl.reset();
 				state.undoMove();
 			}
 		}, " Undo");
@@ -111,7 +119,8 @@ public:
 				{
 					if (!searchControl)
 					{
-						searchControl = std::make_unique<SearchControl>(state, 6000, 20);
+						ponderControl.reset();
+						searchControl = std::make_unique<SearchControl>(state, transpositionTable, searchLimits());
 					}
 				}
 		}, " Search");
@@ -122,6 +131,7 @@ public:
 				{
 					searchControl.reset();
 				}
+				ponderControl.reset();
 			}, " Stop");
 	}
 
@@ -201,6 +211,10 @@ public:
 		{
 			w->print("Calculating...", c->get(0, 0, 0), GLib::WriterFactory::getFont(14), { 800,500,1000,520 });
 		}
+		else if (ponderControl)
+		{
+			w->print("Pondering on " + std::to_string(ponderMove.x) + "," + std::to_string(ponderMove.y), c->get(0, 0, 0), GLib::WriterFactory::getFont(14), { 800,500,1000,520 });
+		}
 		else
 		{
 			if (state.player == Player::P1)
@@ -223,16 +237,32 @@ public:
 			if (searchControl->isFinished())
 			{
 				auto result = searchControl->getResult();
+				auto stats = searchControl->getStats();
+				auto pv = searchControl->getPV();
 				totalCalculationTime += searchControl->getTotalTime();
 				GLib::Out << "Nodes visited: " << result.nodesVisited
 					<< ",   Predicted score: " << result.value
 					<< ",   Total time: " << searchControl->getTotalTime() << "ms"
-					<< ",   Level reached: " << searchControl->getLevelReached() << "\n";
+					<< ",   Level reached: " << searchControl->getLevelReached()
+					<< ",   EBF: " << stats.branchingFactor()
+					<< ",   TT hits: " << (int)(stats.counters.ttHitRate() * 100) << "%"
+					<< ",   First move cutoffs: " << (int)(stats.counters.firstMoveCutoffRate() * 100) << "%\n";
 
 				auto location = state.freeSpots[result.move].location;
 				state.makeMove(location.x, location.y);
 
 				searchControl.reset();
+
+				// Keep searching on the opponent's time, assuming the reply from the principal variation.
+				if (pv.size() > 1 && pv[0] == location && !state.isEndGame() && state.isFreeSpot(pv[1].x, pv[1].y))
+				{
+					ponderMove = pv[1];
+					state.makeMove(ponderMove.x, ponderMove.y);
+					SearchLimits limits = searchLimits();
+					limits.ponder = true;
+					ponderControl = std::make_unique<SearchControl>(state, transpositionTable, limits);
+					state.undoMove();
+				}
 			}
 			else
 			{
@@ -242,6 +272,14 @@ public:
 	}
 
 private:
+	SearchLimits searchLimits()
+	{
+		SearchLimits limits;
+		limits.maxTime = 6000;
+		limits.maxDepth = 20;
+		return limits;
+	}
+
 	D2D1_RECT_F background;
 
 	float hexRadius;
@@ -256,7 +294,10 @@ private:
 
 	State state;
 
+	TranspositionTable transpositionTable{ 1024 };
 	std::unique_ptr<SearchControl> searchControl;
+	std::unique_ptr<SearchControl> ponderControl;
+	Location ponderMove;
 
 	int totalCalculationTime = 0;
 };
\ No newline at end of file
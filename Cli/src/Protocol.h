@@ -0,0 +1,319 @@
+#pragma once
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <mutex>
+
+#include "SearchControl.h"
+#include "Notation.h"
+
+// Line based engine protocol in the style of UCI. Cells are written as x,y, positions
+// may also be given in the dotted notation of Notation.h.
+//
+//   uci                                   -> id, options, uciok
+//   isready                               -> readyok
+//   setoption name <Hash|Threads|MultiPV> value <n>
+//                                         MultiPV counts moves up to symmetry, a line
+//                                         also stands for its images in symmetric positions
+//   setoption name LargePages value <true|false>  takes effect with the next Hash
+//   setoption name NumaPolicy value <off|partition|interleave>  pins the threads, see Numa.h
+//   ucinewgame                            clears the transposition table
+//   position [startpos] [moves x,y ...]   startpos is the centre stone (10,10)
+//   go [depth n] [nodes n] [movetime ms] [infinite] [ponder]
+//                                         infinite ignores movetime and only ends with stop,
+//                                         nodes counts the nodes of all threads together
+//   ponderhit                             the pondered move was played, movetime starts now
+//   stop                                  -> bestmove
+//   quit
+//
+// While searching: info depth <d> multipv <k> score <s> nodes <n> nps <n> time <ms> pv x,y ...
+// The search ends with: bestmove x,y [ponder x,y], the second move is the expected reply.
+// Allocating or clearing the table reports its size, backing and clear time, the first
+// go also reports the time since startup. With a NUMA policy every bestmove is
+// preceded by the nodes per second of each NUMA node.
+class Protocol
+{
+public:
+	Protocol(std::istream& _in, std::ostream& _out)
+		: in(_in), out(_out)
+	{
+		started = std::chrono::steady_clock::now();
+		transpositionTable = std::make_unique<TranspositionTable>(hashSize, largePages, threads, numaPolicy);
+		position = std::make_unique<State>();
+		position->makeMove(10, 10);
+	}
+
+	void run()
+	{
+		std::string line;
+		while (std::getline(in, line))
+		{
+			if (!handle(line))
+			{
+				break;
+			}
+		}
+
+		searchControl.reset();
+	}
+
+private:
+	bool handle(const std::string& line)
+	{
+		std::istringstream stream(line);
+		std::string command;
+		if (!(stream >> command))
+		{
+			return true;
+		}
+
+		try
+		{
+			if (command == "uci")
+			{
+				send("id name Andantino");
+				send("option name Hash type spin default 64 min 1 max 65536");
+				send("option name Threads type spin default 1 min 1 max 256");
+				send("option name MultiPV type spin default 1 min 1 max 271");
+				send("option name Ponder type check default false");
+				send("option name LargePages type check default true");
+				send("option name NumaPolicy type combo default off var off var partition var interleave");
+				send("uciok");
+			}
+			else if (command == "isready")
+			{
+				send("readyok");
+			}
+			else if (command == "setoption")
+			{
+				setOption(stream);
+			}
+			else if (command == "ucinewgame")
+			{
+				searchControl.reset();
+				transpositionTable->clear();
+				send("info string " + tableStats());
+			}
+			else if (command == "position")
+			{
+				setPosition(stream);
+			}
+			else if (command == "go")
+			{
+				go(stream);
+			}
+			else if (command == "ponderhit")
+			{
+				if (searchControl)
+				{
+					searchControl->ponderHit();
+				}
+			}
+			else if (command == "stop")
+			{
+				if (searchControl)
+				{
+					searchControl->forceStop();
+				}
+			}
+			else if (command == "quit")
+			{
+				return false;
+			}
+			else
+			{
+				send("info string unknown command " + command);
+			}
+		}
+		catch (const std::exception& e)
+		{
+			send(std::string("info string ") + e.what());
+		}
+
+		return true;
+	}
+
+	void setOption(std::istringstream& stream)
+	{
+		std::string token, name, value;
+		stream >> token >> name >> token >> value;
+
+		if (name == "Hash")
+		{
+			searchControl.reset();
+			hashSize = std::stoi(value);
+			allocateTable();
+		}
+		else if (name == "NumaPolicy")
+		{
+			searchControl.reset();
+			numaPolicy = parseNumaPolicy(value);
+			allocateTable();
+		}
+		else if (name == "LargePages")
+		{
+			largePages = value == "true";
+		}
+		else if (name == "Threads")
+		{
+			threads = (std::max)(1, std::stoi(value));
+			transpositionTable->setThreads(threads);
+		}
+		else if (name == "Ponder")
+		{
+			// Pondering is driven by go ponder, nothing to set up.
+		}
+		else if (name == "MultiPV")
+		{
+			multiPV = (std::max)(1, std::stoi(value));
+		}
+		else
+		{
+			send("info string unknown option " + name);
+		}
+	}
+
+	void setPosition(std::istringstream& stream)
+	{
+		searchControl.reset();
+
+		std::string token;
+		std::string moves;
+		bool startpos = false;
+		while (stream >> token)
+		{
+			if (token == "startpos")
+			{
+				startpos = true;
+			}
+			else if (token != "moves")
+			{
+				moves += token + " ";
+			}
+		}
+
+		auto next = std::make_unique<State>();
+		if (startpos)
+		{
+			next->makeMove(10, 10);
+		}
+		playMoves(*next, parsePosition(moves));
+		position = std::move(next);
+	}
+
+	void go(std::istringstream& stream)
+	{
+		searchControl.reset();
+
+		if (position->moves.empty())
+		{
+			send("bestmove 10,10");
+			return;
+		}
+		if (position->isEndGame())
+		{
+			send("info string game is over");
+			send("bestmove none");
+			return;
+		}
+
+		if (firstSearch)
+		{
+			firstSearch = false;
+			auto sinceStart = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+			send("info string first search after " + std::to_string(sinceStart) + " ms, " + tableStats());
+		}
+
+		SearchLimits limits;
+		limits.multiPV = multiPV;
+		limits.pinThreads = numaPolicy != NumaPolicy::Off;
+		std::string token;
+		while (stream >> token)
+		{
+			if (token == "depth") stream >> limits.maxDepth;
+			else if (token == "nodes") stream >> limits.maxNodes;
+			else if (token == "movetime") stream >> limits.maxTime;
+			else if (token == "ponder") limits.ponder = true;
+			else if (token == "infinite") limits.infinite = true;
+		}
+		if (limits.infinite)
+		{
+			limits.maxTime = -1;
+		}
+
+		expectedReply.clear();
+		searchControl = std::make_unique<SearchControl>(*position, *transpositionTable, limits, threads,
+			[this](const SearchInfo& info)
+			{
+				if (info.multiPV == 1)
+				{
+					expectedReply = info.pv.size() > 1 ? " ponder " + toString(info.pv[1]) : "";
+				}
+
+				std::string line = "info depth " + std::to_string(info.depth)
+					+ " multipv " + std::to_string(info.multiPV)
+					+ " score " + std::to_string(info.score)
+					+ " nodes " + std::to_string(info.nodes)
+					+ " nps " + std::to_string(info.nps)
+					+ " time " + std::to_string(info.time)
+					+ " pv";
+				for (const auto& location : info.pv)
+				{
+					line += " " + toString(location);
+				}
+				send(line);
+			},
+			[this](const StateTreeResult& result, const SearchStats& stats)
+			{
+				for (int i = 0; i < stats.numaNodeNps.size() && numaPolicy != NumaPolicy::Off; i++)
+				{
+					send("info string numa node " + std::to_string(NumaTopology::get().nodeIds[i]) + " nps " + std::to_string(stats.numaNodeNps[i]));
+				}
+				send("bestmove " + toString(result.moveLocation) + expectedReply);
+			});
+	}
+
+	void allocateTable()
+	{
+		transpositionTable.reset();
+		transpositionTable = std::make_unique<TranspositionTable>(hashSize, largePages, threads, numaPolicy);
+		send("info string " + tableStats());
+	}
+
+	std::string tableStats()
+	{
+		return "hash " + std::to_string(transpositionTable->sizeMB()) + " MB on " + pageBackingName(transpositionTable->pageBacking())
+			+ ", cleared in " + std::to_string((int)(transpositionTable->lastClearTime() * 1000)) + " ms by "
+			+ std::to_string(transpositionTable->lastClearThreads()) + " threads, numa " + numaPolicyName(numaPolicy);
+	}
+
+	static std::string toString(Location location)
+	{
+		return std::to_string(location.x) + "," + std::to_string(location.y);
+	}
+
+	void send(const std::string& line)
+	{
+		std::lock_guard<std::mutex> lock(outMutex);
+		out << line << std::endl;
+	}
+
+	std::istream& in;
+	std::ostream& out;
+	std::mutex outMutex;
+
+	std::chrono::steady_clock::time_point started;
+	bool firstSearch = true;
+
+	int hashSize = 64;
+	int threads = 1;
+	int multiPV = 1;
+	bool largePages = true;
+	NumaPolicy numaPolicy = NumaPolicy::Off;
+	std::unique_ptr<TranspositionTable> transpositionTable;
+	std::string expectedReply; // only touched by the search thread
+
+	std::unique_ptr<State> position;
+	std::unique_ptr<SearchControl> searchControl;
+};
@@ -0,0 +1,389 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <iomanip>
+
+#include "Search.h"
+#include "Playout.h"
+#include "Protocol.h"
+#include "PerfCounters.h"
+#include "Bench.h"
+#include "Notation.h"
+
+// AndantinoCli                              engine protocol on stdin/stdout, see Protocol.h
+// AndantinoCli search <depth> [x,y ...]     iterative deepening to a fixed depth
+// AndantinoCli stats <depth> [x,y ...]      same search, statistics as JSON
+// AndantinoCli profile <depth> [x,y ...]    same search, folded stacks for flamegraph.pl (ANDANTINO_PROFILER)
+// AndantinoCli counters <depth> [x,y ...]   same search, hardware counters per node (Linux perf_event_open)
+// AndantinoCli playout <games> [x,y ...]    bitboard playouts against the makeMove reference
+// AndantinoCli playout verify [games]       replays bitboard playouts through makeMove, fails on any difference
+// AndantinoCli bench [depth] [counters] [hash=MB] [nolargepages]
+//                                           fixed depth search of the bench positions, total nodes and nps
+// AndantinoCli notation [x,y ...]           prints the position in the dotted notation of Notation.h
+// AndantinoCli corpus <amount> [maxMoves] [seed]   random positions, one per line, 2 to maxMoves moves
+//
+// Wherever a move list is expected the dotted notation is accepted as well.
+
+std::string toString(Location location)
+{
+	return std::to_string(location.x) + "," + std::to_string(location.y);
+}
+
+std::vector<Location> movesFromArguments(int argc, char** argv, int first)
+{
+	std::string moves;
+	for (int i = first; i < argc; i++)
+	{
+		moves += std::string(argv[i]) + " ";
+	}
+	if (argc <= first)
+	{
+		moves = "10,10";
+	}
+	return parsePosition(moves);
+}
+
+enum SearchOutput
+{
+	Text, Json, FoldedStacks, HardwareCounters
+};
+
+int searchCommand(const std::vector<Location>& moves, int maxDepth, SearchOutput output)
+{
+#ifndef EnableProfiler
+	if (output == SearchOutput::FoldedStacks)
+	{
+		std::cout << "Built without the profiler, configure with -DANDANTINO_PROFILER=ON\n";
+		return 1;
+	}
+#endif
+
+	State state;
+	playMoves(state, moves);
+	if (state.isEndGame())
+	{
+		std::cout << "Game is over\n";
+		return 1;
+	}
+
+	PerfCounters perfCounters;
+	if (output == SearchOutput::HardwareCounters && !perfCounters.available())
+	{
+		std::cout << "No hardware counters, perf_event_open is not supported or not permitted (perf_event_paranoid)\n";
+		return 1;
+	}
+
+	TranspositionTable transpositionTable;
+	std::atomic<bool> stop(false);
+	SearchContext context(transpositionTable, stop);
+	SearchStats stats;
+
+	StateTreeResult result(0);
+	auto start = std::chrono::steady_clock::now();
+
+	for (int depth = 1; depth <= maxDepth; depth++)
+	{
+		if (output == SearchOutput::HardwareCounters)
+		{
+			perfCounters.start();
+		}
+		result = alphaBeta(state, context, depth, -999, 999);
+		auto counters = output == SearchOutput::HardwareCounters ? perfCounters.stop() : PerfCounterValues();
+
+		auto end = std::chrono::steady_clock::now();
+		stats.addIteration(depth, result.value, context.counters, std::chrono::duration<double>(end - start).count());
+		const auto& iteration = stats.iterations.back();
+
+		if (output == SearchOutput::Text)
+		{
+			std::cout << "Depth: " << depth
+				<< ",   Score: " << result.value
+				<< ",   Nodes visited: " << context.counters.nodes
+				<< ",   Cache hits: " << context.counters.ttHits
+				<< ",   Time: " << (long long)(stats.time * 1000) << "ms"
+				<< ",   Nodes/s: " << stats.nps()
+				<< ",   EBF: " << iteration.branchingFactor
+				<< ",   TT hits: " << (int)(iteration.counters.ttHitRate() * 100) << "%"
+				<< ",   Eval hits: " << (int)(iteration.counters.evalHitRate() * 100) << "%"
+				<< ",   First move cutoffs: " << (int)(iteration.counters.firstMoveCutoffRate() * 100) << "%"
+				<< ",   Move: " << toString(state.freeSpots[result.move].location) << "\n";
+		}
+		else if (output == SearchOutput::HardwareCounters)
+		{
+			long long nodes = iteration.counters.nodes > 0 ? iteration.counters.nodes : 1;
+			std::cout << "Depth: " << depth << ",   Nodes: " << iteration.counters.nodes;
+			for (int i = 0; i < PerfEventAmount; i++)
+			{
+				std::cout << ",   " << PerfCounters::name(i) << "/node: ";
+				if (counters.valid[i])
+				{
+					std::cout << std::fixed << std::setprecision(2) << (double)counters.values[i] / nodes << std::defaultfloat;
+				}
+				else
+				{
+					std::cout << "n/a";
+				}
+			}
+			if (counters.valid[Cycles] && counters.valid[Instructions] && counters.values[Cycles] > 0)
+			{
+				std::cout << ",   IPC: " << std::fixed << std::setprecision(2) << (double)counters.values[Instructions] / counters.values[Cycles] << std::defaultfloat;
+			}
+			std::cout << "\n";
+		}
+
+		if (isDecided(result.value))
+		{
+			break;
+		}
+	}
+
+	if (output == SearchOutput::Json)
+	{
+		std::cout << stats.toJson() << "\n";
+	}
+	else if (output == SearchOutput::FoldedStacks)
+	{
+		Profiler::get().writeFoldedStacks(std::cout);
+	}
+	else
+	{
+		std::cout << "Best move: " << toString(state.freeSpots[result.move].location) << "\n";
+		Instrument(Instrumentation::get().totals().report(std::cout));
+#ifdef EnableProfiler
+		Profiler::get().writeCycleTable(std::cout);
+#endif
+	}
+	return 0;
+}
+
+int playoutCommand(const std::vector<Location>& moves, int games)
+{
+	State state;
+	playMoves(state, moves);
+
+	auto start = std::chrono::steady_clock::now();
+	auto results = runPlayouts(state, games, 1);
+	auto middle = std::chrono::steady_clock::now();
+
+	std::mt19937 gen(1);
+	std::array<int, 3> reference = { 0, 0, 0 };
+	int referenceGames = games / 10 > 0 ? games / 10 : 1;
+	for (int i = 0; i < referenceGames; i++)
+	{
+		reference[randomPlayout(state, gen)]++;
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double batchTime = std::chrono::duration<double>(middle - start).count();
+	double referenceTime = std::chrono::duration<double>(end - middle).count();
+
+	std::cout << "Bitboard: " << games << " games,   Black: " << results[Player::P1]
+		<< ",   White: " << results[Player::P2] << ",   Draw: " << results[Player::Empty]
+		<< ",   Games/s: " << (long long)(games / batchTime) << "\n";
+	std::cout << "makeMove: " << referenceGames << " games,   Black: " << reference[Player::P1]
+		<< ",   White: " << reference[Player::P2] << ",   Draw: " << reference[Player::Empty]
+		<< ",   Games/s: " << (long long)(referenceGames / referenceTime) << "\n";
+	std::cout << "Speedup: " << std::fixed << std::setprecision(1) << (games / batchTime) / (referenceGames / referenceTime) << std::defaultfloat << "x\n";
+
+	return 0;
+}
+
+// The empty board, the centre stone and random positions of 2 to 40 moves, games playouts each.
+int playoutVerifyCommand(int games)
+{
+	std::vector<std::vector<Location>> positions = { {}, { { 10, 10 } } };
+	// The last move is into a hole of the other player, no circle, but a later one still counts.
+	positions.push_back(parsePosition("140.120.139.121.159.138.158.141.122.101.119.157.160.118.102.176.99.100.103.142.82.156.178.123.83.81.177.104.80.161.179.117.197.136.105.155.98.124.137"));
+	for (const auto& position : randomPositions(30, 2, 40, 1))
+	{
+		positions.push_back(parsePosition(position));
+	}
+
+	int mismatches = 0;
+	for (int i = 0; i < (int)positions.size(); i++)
+	{
+		State state;
+		playMoves(state, positions[i]);
+		int found = playoutMismatches(state, games, i + 1);
+		if (found > 0)
+		{
+			std::cout << "Position " << toNotation(positions[i]) << ": " << found << " of " << games << " games differ\n";
+		}
+		mismatches += found;
+	}
+
+	std::cout << (mismatches == 0 ? "All " : "Not all ") << positions.size() * games << " games agree with makeMove\n";
+	return mismatches == 0 ? 0 : 1;
+}
+
+// The total node count is the signature of the search: it only changes when the search does.
+int benchCommand(int depth, bool withCounters, size_t hashMB, bool largePages)
+{
+	PerfCounters perfCounters;
+	if (withCounters && !perfCounters.available())
+	{
+		std::cout << "No hardware counters, perf_event_open is not supported or not permitted (perf_event_paranoid)\n";
+		return 1;
+	}
+
+	auto result = runBench(depth, [](int index, unsigned long long nodes)
+	{
+		std::cout << "Position " << index + 1 << "/" << std::size(benchPositions) << ": " << nodes << "\n";
+	}, hashMB, largePages, withCounters ? &perfCounters : nullptr);
+
+	const auto& counters = result.counters;
+
+	std::cout << "\nDepth: " << depth
+		<< "\nHash: " << result.hashMB << " MB on " << pageBackingName(result.backing)
+		<< "\nNodes: " << result.nodes
+		<< "\nTime: " << (long long)(result.seconds * 1000) << "ms"
+		<< "\nNodes/s: " << result.nps() << "\n";
+
+	if (withCounters)
+	{
+		for (int i = 0; i < PerfEventAmount; i++)
+		{
+			std::cout << PerfCounters::name(i) << "/node: ";
+			if (counters.valid[i])
+			{
+				std::cout << std::fixed << std::setprecision(2) << (double)counters.values[i] / result.nodes << std::defaultfloat << "\n";
+			}
+			else
+			{
+				std::cout << "n/a\n";
+			}
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc == 1)
+	{
+		Protocol protocol(std::cin, std::cout);
+		protocol.run();
+		return 0;
+	}
+	if (std::string(argv[1]) == "notation")
+	{
+		try
+		{
+			std::cout << toNotation(movesFromArguments(argc, argv, 2)) << "\n";
+			return 0;
+		}
+		catch (const std::exception& e)
+		{
+			std::cout << e.what() << "\n";
+			return 1;
+		}
+	}
+	if (std::string(argv[1]) == "corpus" && argc > 2)
+	{
+		try
+		{
+			int amount = std::stoi(argv[2]);
+			int maxMoves = argc > 3 ? std::stoi(argv[3]) : 60;
+			unsigned int seed = argc > 4 ? (unsigned int)std::stoul(argv[4]) : 1;
+
+			std::cout << "# " << amount << " random positions, 2 to " << maxMoves << " moves, seed " << seed << "\n";
+			for (const auto& position : randomPositions(amount, 2, maxMoves, seed))
+			{
+				std::cout << position << "\n";
+			}
+			return 0;
+		}
+		catch (const std::exception& e)
+		{
+			std::cout << e.what() << "\n";
+			return 1;
+		}
+	}
+	if (std::string(argv[1]) == "playout" && argc > 2 && std::string(argv[2]) == "verify")
+	{
+		try
+		{
+			return playoutVerifyCommand(argc > 3 ? std::stoi(argv[3]) : 1000);
+		}
+		catch (const std::exception& e)
+		{
+			std::cout << e.what() << "\n";
+			return 1;
+		}
+	}
+	if (std::string(argv[1]) == "bench")
+	{
+		try
+		{
+			int depth = BenchDepth;
+			bool withCounters = false;
+			size_t hashMB = 64;
+			bool largePages = true;
+			for (int i = 2; i < argc; i++)
+			{
+				std::string option = argv[i];
+				if (option == "counters") withCounters = true;
+				else if (option == "nolargepages") largePages = false;
+				else if (option.rfind("hash=", 0) == 0) hashMB = std::stoul(option.substr(5));
+				else depth = std::stoi(option);
+			}
+			return benchCommand(depth, withCounters, hashMB, largePages);
+		}
+		catch (const std::exception& e)
+		{
+			std::cout << e.what() << "\n";
+			return 1;
+		}
+	}
+	if (argc < 3)
+	{
+		std::cout << "Usage: AndantinoCli\n"
+			<< "       AndantinoCli search <depth> [x,y ...]\n"
+			<< "       AndantinoCli stats <depth> [x,y ...]\n"
+			<< "       AndantinoCli profile <depth> [x,y ...]\n"
+			<< "       AndantinoCli counters <depth> [x,y ...]\n"
+			<< "       AndantinoCli playout <games> [x,y ...]\n"
+			<< "       AndantinoCli playout verify [games]\n"
+			<< "       AndantinoCli bench [depth] [counters] [hash=MB] [nolargepages]\n"
+			<< "       AndantinoCli notation [x,y ...]\n"
+			<< "       AndantinoCli corpus <amount> [maxMoves] [seed]\n";
+		return 1;
+	}
+
+	try
+	{
+		std::string command = argv[1];
+		int amount = std::stoi(argv[2]);
+		auto moves = movesFromArguments(argc, argv, 3);
+
+		if (command == "search")
+		{
+			return searchCommand(moves, amount, SearchOutput::Text);
+		}
+		else if (command == "stats")
+		{
+			return searchCommand(moves, amount, SearchOutput::Json);
+		}
+		else if (command == "profile")
+		{
+			return searchCommand(moves, amount, SearchOutput::FoldedStacks);
+		}
+		else if (command == "counters")
+		{
+			return searchCommand(moves, amount, SearchOutput::HardwareCounters);
+		}
+		else if (command == "playout")
+		{
+			return playoutCommand(moves, amount);
+		}
+
+		std::cout << "Unknown command: " << command << "\n";
+		return 1;
+	}
+	catch (const std::exception& e)
+	{
+		std::cout << e.what() << "\n";
+		return 1;
+	}
+}
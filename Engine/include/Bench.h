@@ -0,0 +1,139 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+
+#include "Search.h"
+#include "PerfCounters.h"
+
+#define BenchDepth 6
+
+// Positions of seeded self play games from 4 to 46 plies, none of them decided at depth 3.
+const char* const benchPositions[] =
+{
+	"10,10 9,9 10,9 11,10",
+	"10,10 9,11 10,11 11,10",
+	"10,10 11,10 10,9 10,11 9,11",
+	"10,10 11,10 10,11 10,9 9,9 9,11",
+	"10,10 11,10 10,9 9,9 10,11 9,11 9,10",
+	"10,10 9,10 9,9 10,9 9,11 10,11 11,10 8,9",
+	"10,10 11,10 10,9 9,9 10,11 9,11 9,10 11,9 12,10",
+	"10,10 11,10 10,9 9,9 10,11 9,11 10,12 11,12 11,9 11,8",
+	"10,10 11,10 10,9 9,9 10,11 9,11 9,10 11,11 12,10 11,12",
+	"10,10 11,10 10,11 9,11 10,9 9,9 9,10 11,11 12,10 11,12 8,9",
+	"10,10 11,10 10,9 9,9 11,9 11,8 10,8 10,11 12,8 9,11 12,9 10,12",
+	"10,10 9,10 9,9 10,9 9,11 8,11 10,11 11,10 8,10 10,8 9,8 7,11 8,9",
+	"10,10 11,10 10,9 9,9 10,11 9,11 9,10 10,8 10,12 11,8 9,12 8,11 11,12 9,8",
+	"10,10 11,10 10,9 9,9 10,8 11,8 11,9 10,11 11,11 9,10 8,9 11,12 10,12 8,10 12,10",
+	"10,10 11,10 10,9 9,9 10,11 9,10 10,8 11,8 8,9 9,8 10,7 9,11 9,7 10,12 8,8 7,9",
+	"10,10 10,11 11,10 10,9 9,11 9,10 9,9 11,11 11,12 12,10 12,11 12,12 8,11 9,12 8,9 8,10",
+	"10,10 11,10 10,9 10,11 9,11 9,9 10,12 9,12 8,11 11,12 11,9 11,8 12,8 11,7 10,7 9,10 11,11",
+	"10,10 11,10 10,9 11,9 11,8 9,9 12,8 11,7 10,11 12,9 9,11 12,10 12,7 13,8 13,7 11,11 11,12 13,6",
+	"10,10 11,10 10,9 11,9 11,8 12,8 11,7 9,9 12,7 12,6 10,11 9,11 9,10 10,7 8,11 8,10 11,6 13,8 11,5",
+	"10,10 10,9 9,9 9,10 11,10 10,11 9,11 10,8 11,8 10,12 9,8 9,7 11,12 8,7 9,6 10,6 8,11 10,13 11,13 12,12",
+	"10,10 10,11 9,11 10,12 9,12 9,10 9,13 8,11 8,13 8,12 7,13 8,14 10,13 10,14 9,9 10,9 11,10 10,8 11,8 10,7 9,8",
+	"10,10 11,10 10,9 9,9 10,11 9,11 9,10 11,9 12,10 11,8 12,8 12,9 10,12 8,9 11,12 9,12 11,7 10,7 8,10 8,11 9,13 12,7",
+	"10,10 11,10 10,11 9,11 11,11 11,12 10,12 10,13 11,13 9,13 10,14 11,14 12,10 12,11 9,14 9,15 8,13 8,14 8,15 12,14 11,15 12,15",
+	"10,10 10,11 11,10 10,9 9,11 9,10 9,9 11,11 10,8 12,10 12,11 12,12 9,8 11,12 13,12 13,11 14,12 13,13 12,13 8,9 11,8 11,9 9,7",
+	"10,10 11,10 10,9 9,9 10,11 10,8 11,8 9,11 10,7 11,7 9,10 12,8 11,6 11,9 12,7 10,6 12,9 13,8 9,8 11,11 10,5 12,10 12,11 11,5",
+	"10,10 11,10 10,9 10,11 9,11 9,9 10,12 9,12 11,9 11,8 10,8 9,10 8,11 11,11 8,9 9,8 12,10 8,8 8,7 12,8 11,7 8,10 7,9 12,11 7,10",
+	"10,10 11,10 10,9 11,9 11,8 9,9 12,8 11,7 10,11 9,11 9,10 10,8 10,7 12,10 8,11 8,10 9,8 10,12 7,11 7,10 9,7 8,9 7,9 8,8 10,6 12,7",
+	"10,10 11,10 10,9 9,9 9,10 9,11 10,11 11,9 12,10 11,8 12,8 12,9 13,10 12,11 13,9 14,10 11,7 12,7 14,9 14,8 10,7 11,6 12,6 13,7 14,7 13,8 14,6",
+	"10,10 11,10 10,9 9,9 10,11 9,11 11,9 11,8 10,8 9,10 12,10 11,11 12,9 8,11 8,9 8,10 7,9 8,8 10,12 10,7 11,7 11,6 7,8 6,9 12,6 6,8 9,12 8,12",
+	"10,10 11,10 10,9 9,9 10,11 9,11 9,10 11,11 12,10 11,12 12,12 12,11 10,8 11,8 10,7 9,7 9,8 8,9 8,7 8,10 7,9 8,8 7,7 8,6 9,6 10,6 11,7 9,5",
+	"10,10 11,10 10,9 9,9 11,9 11,8 10,8 10,11 12,8 9,11 12,9 10,12 11,12 13,8 12,10 13,9 11,11 10,13 9,13 9,10 8,9 12,7 14,8 8,10 7,9 12,11 10,7 9,7 9,8",
+	"10,10 11,10 10,9 9,9 10,8 11,8 9,8 8,9 9,7 8,8 7,9 9,10 7,8 7,7 9,11 6,9 6,8 5,9 11,9 10,11 6,10 5,10 4,9 5,8 8,11 10,7 8,7 4,8 9,12 8,10",
+	"10,10 11,10 10,9 9,9 10,11 9,11 9,10 8,11 9,12 8,10 7,11 8,12 11,11 11,12 12,12 10,12 12,11 10,13 7,10 6,11 6,10 6,9 5,9 5,10 4,9 5,8 4,8 4,7 13,12 3,7 13,11",
+	"10,10 11,10 10,9 9,9 10,11 9,11 9,10 11,9 12,10 11,8 12,8 12,9 10,12 13,10 13,9 11,12 10,13 10,8 9,13 10,7 9,8 8,9 14,10 14,9 11,11 11,13 11,14 8,8 7,9 8,10 12,14 11,15",
+	"10,10 10,9 9,9 9,10 11,10 10,11 9,11 10,8 11,8 8,11 8,10 9,12 8,12 10,7 9,7 9,8 8,13 7,11 9,13 7,13 9,14 11,11 11,12 10,13 11,13 11,14 8,14 10,12 7,10 7,9 8,8 7,14 7,15",
+	"10,10 11,10 10,9 9,9 10,11 9,11 9,10 11,9 12,10 8,9 9,8 8,10 7,9 11,8 12,8 10,8 11,11 10,7 11,12 12,9 7,10 12,11 13,8 6,9 13,10 12,7 13,7 13,6 8,11 8,8 7,8 13,11 14,6 14,7",
+	"10,10 11,10 10,9 9,9 10,11 9,11 9,10 11,9 12,10 12,9 12,8 11,8 13,10 12,11 13,9 14,10 13,11 11,7 10,7 11,6 12,6 12,7 13,8 11,11 11,12 13,7 12,12 11,13 10,13 13,12 14,9 14,11 14,12 14,8",
+	"10,10 11,10 10,9 9,9 10,11 9,10 10,8 11,8 8,9 9,11 10,7 11,7 11,6 10,12 9,12 8,10 8,11 12,8 12,7 10,6 11,11 7,9 7,10 13,8 10,5 11,5 9,5 10,4 13,7 14,8 13,9 11,9 6,9 6,10 11,4",
+	"10,10 11,10 10,9 10,11 9,11 9,9 10,12 9,12 11,9 11,8 10,8 9,10 8,11 11,11 8,9 9,8 9,13 8,12 12,8 10,7 10,13 11,7 12,7 9,7 8,7 11,12 10,6 8,10 12,12 9,6 8,13 7,13 11,13 12,13 7,12 11,14",
+	"10,10 11,10 10,9 9,9 10,11 9,10 10,8 11,8 8,9 9,11 11,11 11,12 8,11 10,12 10,13 8,10 12,10 11,9 12,9 13,10 13,9 13,8 12,12 11,13 10,7 9,7 9,12 8,12 7,11 7,9 7,10 10,6 9,6 6,11 12,8 11,7 6,9",
+	"10,10 11,10 10,9 9,9 10,11 9,11 9,10 11,9 12,10 11,8 12,8 12,9 8,9 8,10 8,11 11,7 10,7 10,8 13,8 13,9 14,8 14,9 14,10 7,9 7,10 15,8 15,9 15,10 7,11 8,12 10,12 9,12 8,13 7,12 6,9 9,7 11,11 9,13",
+	"10,10 11,10 10,9 9,9 10,11 10,8 11,8 9,11 10,7 9,10 11,7 8,11 8,9 9,7 10,6 10,12 11,12 9,12 8,12 9,6 9,13 10,13 9,5 11,9 8,5 9,4 8,7 10,5 10,4 8,8 7,9 7,11 7,12 7,13 11,6 12,6 12,7 7,8 6,9",
+	"10,10 11,10 10,9 9,9 10,8 9,10 10,11 11,8 11,11 11,12 12,12 12,11 8,9 8,10 8,11 9,11 10,12 7,9 7,10 6,9 7,8 10,13 8,8 6,8 9,8 7,11 5,9 6,10 6,11 12,10 11,9 6,7 5,7 5,11 5,10 9,7 10,7 4,11 5,12 12,9",
+	"10,10 11,10 10,9 9,9 9,10 10,8 9,11 11,8 10,7 9,8 9,7 10,11 10,12 9,12 11,11 11,7 8,9 8,8 12,8 10,6 9,6 12,7 12,6 8,11 8,10 8,12 13,6 12,5 8,13 7,13 11,5 12,10 8,14 12,11 13,10 9,14 11,6 12,4 13,4 9,5",
+	"10,10 11,10 10,9 9,9 10,11 9,11 9,10 11,9 11,8 12,8 12,9 11,7 12,7 13,8 10,7 11,6 12,6 13,6 12,5 13,5 13,9 13,10 13,4 10,8 9,8 10,6 11,5 10,5 10,12 14,4 14,8 11,12 13,7 14,9 8,9 9,7 13,3 8,10 9,6 8,8 14,3",
+	"10,10 11,10 10,9 9,9 10,8 11,8 11,9 10,11 11,11 9,10 8,9 11,12 10,12 8,10 10,13 8,11 12,12 7,11 9,11 8,12 10,7 11,7 9,12 8,13 7,13 11,6 7,10 8,14 11,13 12,10 12,6 12,13 11,14 6,11 7,14 7,15 8,15 12,7 7,12 12,11 13,10 9,7",
+	"10,10 11,10 10,11 9,11 10,9 9,9 9,10 11,11 12,10 11,12 12,12 12,11 8,11 8,10 8,9 7,9 7,10 8,8 7,8 7,11 8,12 7,7 7,12 7,13 8,7 11,13 10,13 6,13 7,14 10,8 8,13 9,8 11,8 8,14 12,13 7,15 8,15 12,14 13,10 12,9 6,11 6,12 5,13",
+	"10,10 11,10 10,9 9,9 10,11 10,8 11,8 9,11 10,7 11,7 9,10 11,9 12,8 9,8 12,10 11,11 10,12 12,11 12,12 11,12 10,13 9,13 8,11 9,12 10,14 8,13 9,7 11,14 13,12 12,13 8,7 13,11 10,6 11,6 13,13 14,12 14,13 14,11 9,14 14,14 10,15 15,14 12,6 9,15",
+	"10,10 11,10 10,9 9,9 10,11 9,11 10,8 11,8 11,9 11,11 10,12 9,12 8,11 9,13 12,10 8,12 7,11 7,12 12,9 12,11 7,13 9,8 12,12 8,9 8,8 9,7 8,7 12,8 13,8 10,13 13,9 8,10 9,6 8,13 10,6 9,5 8,14 8,6 8,5 7,14 7,15 8,15 9,4 9,14 9,15",
+	"10,10 11,10 10,9 9,9 10,11 9,11 9,10 8,11 9,12 8,10 7,11 8,12 11,11 11,12 12,12 12,11 12,10 11,9 10,8 12,9 12,8 11,8 13,8 12,7 13,7 14,8 13,6 13,9 12,6 11,7 11,13 14,9 12,5 14,6 14,7 12,13 12,14 13,14 12,15 11,15 12,16 7,10 13,16 13,15 7,9 6,11",
+};
+
+struct BenchResult
+{
+	unsigned long long nodes = 0;
+	double seconds = 0;
+	size_t hashMB = 0;
+	PageBacking backing = PageBacking::Default;
+	PerfCounterValues counters; // only with perfCounters
+
+	long long nps() const
+	{
+		return (long long)(nodes / (seconds > 0 ? seconds : 1));
+	}
+};
+
+// Iterative deepening to depth on every bench position, single threaded with a fresh
+// table per position, so the node count only depends on the search itself. The table
+// size and page backing only change the speed, as long as the table is large enough.
+// Time and perfCounters only cover the searches, not allocating and clearing the tables.
+inline BenchResult runBench(int depth = BenchDepth, std::function<void(int, unsigned long long)> onPosition = nullptr, size_t hashMB = 64, bool largePages = true,
+	PerfCounters* perfCounters = nullptr)
+{
+	BenchResult result;
+	TranspositionTable transpositionTable(hashMB, largePages);
+	transpositionTable.localTable(0);
+	result.hashMB = transpositionTable.sizeMB();
+	result.backing = transpositionTable.pageBacking();
+	std::atomic<bool> stop(false);
+
+	if (perfCounters)
+	{
+		perfCounters->start();
+		perfCounters->pause();
+	}
+
+	int index = 0;
+	for (const char* moves : benchPositions)
+	{
+		State state;
+		playMoves(state, parseMoves(moves));
+		transpositionTable.clear();
+		SearchContext context(transpositionTable, stop);
+
+		if (perfCounters)
+		{
+			perfCounters->resume();
+		}
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 1; i <= depth; i++)
+		{
+			if (isDecided(alphaBeta(state, context, i, -999, 999).value))
+			{
+				break;
+			}
+		}
+		result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (perfCounters)
+		{
+			perfCounters->pause();
+		}
+		result.nodes += context.counters.nodes;
+
+		if (onPosition)
+		{
+			onPosition(index, context.counters.nodes);
+		}
+		index++;
+	}
+
+	if (perfCounters)
+	{
+		result.counters = perfCounters->stop();
+	}
+	return result;
+}
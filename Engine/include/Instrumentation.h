@@ -0,0 +1,216 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <ostream>
+
+// Per thread counters and histograms. Every thread writes to its own cache line
+// aligned slot, so counting never shares a line between threads; the slots are
+// only summed when somebody asks for the totals. Without EnableInstrumentation
+// (CMake option ANDANTINO_INSTRUMENTATION) Instrument(x) removes the call sites.
+
+#ifdef EnableInstrumentation
+#define Instrument(x) x
+#else
+#define Instrument(x)
+#endif
+
+enum Counter
+{
+	MakeMoves, Evaluations, CircleChecks, TableProbes, TableStores, CounterAmount
+};
+
+enum Histogram
+{
+	CutoffIndex,   // position in the move order of the move that caused a beta cutoff
+	MovesSearched, // moves searched in an interior node
+	NodeDepth,     // remaining depth of every node
+	HistogramAmount
+};
+
+#define HistogramBuckets 32
+
+struct InstrumentationTotals
+{
+	std::array<unsigned long long, CounterAmount> counters{};
+	std::array<std::array<unsigned long long, HistogramBuckets>, HistogramAmount> histograms{};
+
+	InstrumentationTotals& operator+=(const InstrumentationTotals& other)
+	{
+		for (int i = 0; i < CounterAmount; i++)
+		{
+			counters[i] += other.counters[i];
+		}
+		for (int i = 0; i < HistogramAmount; i++)
+		{
+			for (int j = 0; j < HistogramBuckets; j++)
+			{
+				histograms[i][j] += other.histograms[i][j];
+			}
+		}
+		return *this;
+	}
+
+	void report(std::ostream& out) const
+	{
+		static const char* counterNames[CounterAmount] = { "MakeMoves", "Evaluations", "CircleChecks", "TableProbes", "TableStores" };
+		static const char* histogramNames[HistogramAmount] = { "CutoffIndex", "MovesSearched", "NodeDepth" };
+
+		for (int i = 0; i < CounterAmount; i++)
+		{
+			out << counterNames[i] << ": " << counters[i] << "\n";
+		}
+		for (int i = 0; i < HistogramAmount; i++)
+		{
+			out << histogramNames[i] << ":";
+			int last = HistogramBuckets - 1;
+			while (last > 0 && histograms[i][last] == 0)
+			{
+				last--;
+			}
+			for (int j = 0; j <= last; j++)
+			{
+				out << " " << histograms[i][j];
+			}
+			out << "\n";
+		}
+	}
+};
+
+class Instrumentation
+{
+public:
+	// One thread writes, readers only load. Relaxed load plus store avoids a locked add.
+	struct alignas(64) Slot
+	{
+		std::array<std::atomic<unsigned long long>, CounterAmount> counters{};
+		std::array<std::array<std::atomic<unsigned long long>, HistogramBuckets>, HistogramAmount> histograms{};
+
+		void add(std::atomic<unsigned long long>& value, unsigned long long amount)
+		{
+			value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+		}
+
+		void fold(InstrumentationTotals& totals) const
+		{
+			for (int i = 0; i < CounterAmount; i++)
+			{
+				totals.counters[i] += counters[i].load(std::memory_order_relaxed);
+			}
+			for (int i = 0; i < HistogramAmount; i++)
+			{
+				for (int j = 0; j < HistogramBuckets; j++)
+				{
+					totals.histograms[i][j] += histograms[i][j].load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		void reset()
+		{
+			for (auto& counter : counters)
+			{
+				counter.store(0, std::memory_order_relaxed);
+			}
+			for (auto& histogram : histograms)
+			{
+				for (auto& bucket : histogram)
+				{
+					bucket.store(0, std::memory_order_relaxed);
+				}
+			}
+		}
+	};
+
+	static Instrumentation& get()
+	{
+		static Instrumentation instance;
+		return instance;
+	}
+
+	static void count(Counter counter, unsigned long long amount = 1)
+	{
+		Slot& slot = threadSlot();
+		slot.add(slot.counters[counter], amount);
+	}
+
+	// Values above the last bucket are counted in the last bucket.
+	static void sample(Histogram histogram, int value)
+	{
+		int bucket = value < 0 ? 0 : (value < HistogramBuckets ? value : HistogramBuckets - 1);
+		Slot& slot = threadSlot();
+		slot.add(slot.histograms[histogram][bucket], 1);
+	}
+
+	InstrumentationTotals totals()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		InstrumentationTotals result = retired;
+		for (const auto& slot : slots)
+		{
+			slot->fold(result);
+		}
+		return result;
+	}
+
+	// Not exact while other threads are counting.
+	void reset()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		retired = InstrumentationTotals();
+		for (auto& slot : slots)
+		{
+			slot->reset();
+		}
+	}
+
+private:
+	// Slots of finished threads are folded into retired and reused by the next thread.
+	struct SlotOwner
+	{
+		SlotOwner() : slot(get().acquire())
+		{
+		}
+		~SlotOwner()
+		{
+			get().release(slot);
+		}
+
+		Slot* slot;
+	};
+
+	static Slot& threadSlot()
+	{
+		thread_local SlotOwner owner;
+		return *owner.slot;
+	}
+
+	Slot* acquire()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!unused.empty())
+		{
+			Slot* slot = unused.back();
+			unused.pop_back();
+			return slot;
+		}
+		slots.push_back(std::make_unique<Slot>());
+		return slots.back().get();
+	}
+
+	void release(Slot* slot)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		slot->fold(retired);
+		slot->reset();
+		unused.push_back(slot);
+	}
+
+	std::mutex mutex;
+	std::vector<std::unique_ptr<Slot>> slots;
+	std::vector<Slot*> unused;
+	InstrumentationTotals retired;
+};
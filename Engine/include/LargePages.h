@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// Memory for large tables, on 2 MB pages when the system gives them so random accesses
+// miss the TLB less often. Linux first tries reserved huge pages (MAP_HUGETLB), then
+// asks for transparent huge pages on 2 MB aligned memory (MADV_HUGEPAGE). Windows uses
+// large pages when the process holds the lock pages privilege. Everything else gets
+// ordinary cache line aligned memory.
+
+enum class PageBacking
+{
+	Default, TransparentHugePages, HugeTLB, LargePages
+};
+
+#define HugePageSize ((size_t)2 * 1024 * 1024)
+
+inline const char* pageBackingName(PageBacking backing)
+{
+	static const char* names[] = { "default pages", "transparent huge pages", "hugetlb pages", "large pages" };
+	return names[(int)backing];
+}
+
+// Size is rounded up to whole huge pages. Returns nullptr when even ordinary memory fails.
+inline void* allocateLarge(size_t& size, bool largePages, PageBacking& backing)
+{
+	size = (size + HugePageSize - 1) / HugePageSize * HugePageSize;
+	backing = PageBacking::Default;
+
+#if defined(_WIN32)
+	SIZE_T minimum = GetLargePageMinimum();
+	if (largePages && minimum > 0 && size % minimum == 0)
+	{
+		void* memory = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+		if (memory)
+		{
+			backing = PageBacking::LargePages;
+			return memory;
+		}
+	}
+	return _aligned_malloc(size, 64);
+#else
+#if defined(__linux__)
+	if (largePages)
+	{
+		void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (memory != MAP_FAILED)
+		{
+			backing = PageBacking::HugeTLB;
+			return memory;
+		}
+
+		memory = std::aligned_alloc(HugePageSize, size);
+		if (memory && madvise(memory, size, MADV_HUGEPAGE) == 0)
+		{
+			backing = PageBacking::TransparentHugePages;
+		}
+		return memory;
+	}
+#endif
+	return std::aligned_alloc(64, size);
+#endif
+}
+
+inline void freeLarge(void* memory, size_t size, PageBacking backing)
+{
+	if (!memory)
+	{
+		return;
+	}
+
+#if defined(_WIN32)
+	if (backing == PageBacking::LargePages)
+	{
+		VirtualFree(memory, 0, MEM_RELEASE);
+		return;
+	}
+	_aligned_free(memory);
+#else
+#if defined(__linux__)
+	if (backing == PageBacking::HugeTLB)
+	{
+		munmap(memory, size);
+		return;
+	}
+#endif
+	std::free(memory);
+#endif
+}
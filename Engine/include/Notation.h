@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Search.h"
+
+// Compact notation: the move list as linear cell indices (Board::linearIndex, 0 to 270)
+// joined by dots, for example "135.134.116". Together with the "x,y" lists of
+// parseMoves this is what files and command lines accept.
+
+inline const Board& notationBoard()
+{
+	static const Board board;
+	return board;
+}
+
+inline std::string toNotation(const std::vector<Location>& moves)
+{
+	const Board& board = notationBoard();
+	std::string text;
+	text.reserve(moves.size() * 4);
+
+	for (const auto& location : moves)
+	{
+		if (!text.empty())
+		{
+			text += '.';
+		}
+
+		int index = board.linearIndex[location.x][location.y];
+		if (index >= 100) text += (char)('0' + index / 100);
+		if (index >= 10) text += (char)('0' + index / 10 % 10);
+		text += (char)('0' + index % 10);
+	}
+
+	return text;
+}
+
+inline std::string toNotation(const State& state)
+{
+	std::vector<Location> moves;
+	for (const auto& move : state.moves)
+	{
+		moves.push_back(move.location);
+	}
+	return toNotation(moves);
+}
+
+inline std::vector<Location> parseNotation(const std::string& text)
+{
+	const Board& board = notationBoard();
+	std::vector<Location> moves;
+
+	size_t i = 0;
+	while (i < text.size())
+	{
+		int index = 0;
+		size_t start = i;
+		while (i < text.size() && text[i] >= '0' && text[i] <= '9' && i - start < 3)
+		{
+			index = index * 10 + (text[i] - '0');
+			i++;
+		}
+
+		if (i == start || index >= board.amount || (i < text.size() && text[i] != '.') || (i + 1 == text.size()))
+		{
+			throw std::invalid_argument("Invalid notation: " + text);
+		}
+		i++;
+
+		moves.push_back(board.reverseLinearIndex[index]);
+	}
+
+	return moves;
+}
+
+// Either notation: whitespace separated "x,y" cells, or dotted linear indices.
+inline std::vector<Location> parsePosition(const std::string& text)
+{
+	if (text.find(',') != std::string::npos)
+	{
+		return parseMoves(text);
+	}
+
+	std::istringstream stream(text);
+	std::vector<Location> moves;
+	std::string token;
+	while (stream >> token)
+	{
+		auto part = parseNotation(token);
+		moves.insert(moves.end(), part.begin(), part.end());
+	}
+	return moves;
+}
+
+// Plays random legal moves the way the old simulate() built its openings: walk
+// freeSpots and take each legal spot with chance 1 in 4. Stops early when the game ends.
+inline void playRandomMoves(State& state, int amount, std::mt19937& gen)
+{
+	std::uniform_int_distribution<> dis(1, 4);
+	if (state.moves.empty() && amount > 0)
+	{
+		state.makeMove(10, 10);
+		amount--;
+	}
+
+	while (amount > 0 && !state.isEndGame())
+	{
+		for (int i = 0; i < (int)state.freeSpots.size(); i++)
+		{
+			if (state.freeSpots[i].moveIndex > 0 && dis(gen) == 1)
+			{
+				state.makeMove(state.freeSpots[i].location.x, state.freeSpots[i].location.y);
+				amount--;
+				break;
+			}
+		}
+	}
+}
+
+// Random positions that are still being played, stratified by move count: position i
+// has minMoves + i % (maxMoves - minMoves + 1) moves.
+inline std::vector<std::string> randomPositions(int amount, int minMoves, int maxMoves, unsigned int seed)
+{
+	std::mt19937 gen(seed);
+	std::vector<std::string> positions;
+
+	minMoves = (std::max)(minMoves, 1);
+	maxMoves = (std::max)(maxMoves, minMoves);
+
+	for (int i = 0; i < amount; i++)
+	{
+		int length = minMoves + i % (maxMoves - minMoves + 1);
+		for (int attempt = 0; attempt < 1000; attempt++)
+		{
+			State state;
+			playRandomMoves(state, length, gen);
+			if ((int)state.moves.size() == length && !state.isEndGame())
+			{
+				positions.push_back(toNotation(state));
+				break;
+			}
+		}
+	}
+
+	return positions;
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+// NUMA nodes and their cores, read from /sys on Linux without libnuma. Elsewhere, or
+// when /sys has no nodes, all cores form node 0. Search thread i runs on node
+// i % nodes, so a pool is spread evenly over the sockets.
+//
+// Partition: every thread is pinned to a core of its node, and the table is cleared by
+// threads pinned the same way, so each node holds an equal slice of the table.
+// Interleave: threads are pinned the same way, and the table pages are spread over all
+// nodes page by page.
+
+enum class NumaPolicy
+{
+	Off, Partition, Interleave
+};
+
+inline const char* numaPolicyName(NumaPolicy policy)
+{
+	static const char* names[] = { "off", "partition", "interleave" };
+	return names[(int)policy];
+}
+
+inline NumaPolicy parseNumaPolicy(const std::string& text)
+{
+	if (text == "partition") return NumaPolicy::Partition;
+	if (text == "interleave") return NumaPolicy::Interleave;
+	return NumaPolicy::Off;
+}
+
+class NumaTopology
+{
+public:
+	static const NumaTopology& get()
+	{
+		static const NumaTopology topology;
+		return topology;
+	}
+
+	int nodeCount() const
+	{
+		return (int)nodes.size();
+	}
+
+	int nodeOfThread(int index) const
+	{
+		return index % nodeCount();
+	}
+
+	// Threads of a node take its cores in turn.
+	int coreOfThread(int index) const
+	{
+		const auto& cores = nodes[nodeOfThread(index)];
+		return cores[(index / nodeCount()) % cores.size()];
+	}
+
+	// Pins the calling thread to the core of search thread index.
+	bool pinThread(int index) const
+	{
+		int core = coreOfThread(index);
+#if defined(_WIN32)
+		return core < 64 && SetThreadAffinityMask(GetCurrentThread(), 1ull << core) != 0;
+#elif defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(core, &set);
+		return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+		return false;
+#endif
+	}
+
+	// Pages of the range not yet touched are spread over all nodes.
+	bool interleave(void* memory, size_t size) const
+	{
+#if defined(__linux__) && defined(SYS_mbind)
+		if (nodeCount() < 2 || nodeIds.back() >= 64)
+		{
+			return false;
+		}
+
+		unsigned long mask = 0;
+		for (int id : nodeIds)
+		{
+			mask |= 1ul << id;
+		}
+		const int MpolInterleave = 3;
+		return syscall(SYS_mbind, memory, size, MpolInterleave, &mask, 64, 0) == 0;
+#else
+		return false;
+#endif
+	}
+
+	std::vector<std::vector<int>> nodes; // cores per node
+	std::vector<int> nodeIds;            // node number in /sys per node
+
+private:
+	NumaTopology()
+	{
+#if defined(__linux__)
+		std::ifstream online("/sys/devices/system/node/online");
+		std::string list;
+		if (online && std::getline(online, list))
+		{
+			for (int id : parseCpuList(list))
+			{
+				std::ifstream file("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+				std::string cpus;
+				if (file && std::getline(file, cpus) && !parseCpuList(cpus).empty())
+				{
+					nodes.push_back(parseCpuList(cpus));
+					nodeIds.push_back(id);
+				}
+			}
+		}
+#endif
+
+		if (nodes.empty())
+		{
+			nodes.emplace_back();
+			nodeIds.push_back(0);
+			for (int core = 0; core < (int)(std::max)(1u, std::thread::hardware_concurrency()); core++)
+			{
+				nodes[0].push_back(core);
+			}
+		}
+	}
+
+	// "0-3,8-11" style lists, of cores as well as of nodes.
+	static std::vector<int> parseCpuList(const std::string& list)
+	{
+		std::vector<int> cores;
+		std::istringstream stream(list);
+		std::string range;
+		while (std::getline(stream, range, ','))
+		{
+			size_t dash = range.find('-');
+			try
+			{
+				int first = std::stoi(range.substr(0, dash));
+				int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+				for (int core = first; core <= last; core++)
+				{
+					cores.push_back(core);
+				}
+			}
+			catch (const std::exception&)
+			{
+			}
+		}
+		return cores;
+	}
+};
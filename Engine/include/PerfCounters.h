@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware counters of the calling thread through Linux perf_event_open, user space
+// only so perf_event_paranoid 2 is enough. Every event is opened on its own; events
+// the machine or the VM does not offer are reported as unavailable. Other platforms
+// have no counters at all.
+
+enum PerfEvent
+{
+	Cycles, Instructions, L1DataMisses, LastLevelMisses, BranchMisses, PerfEventAmount
+};
+
+struct PerfCounterValues
+{
+	std::array<unsigned long long, PerfEventAmount> values{};
+	std::array<bool, PerfEventAmount> valid{};
+};
+
+class PerfCounters
+{
+public:
+	PerfCounters()
+	{
+		descriptors.fill(-1);
+
+#ifdef __linux__
+		const unsigned long long cache = PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+		const std::array<std::pair<unsigned int, unsigned long long>, PerfEventAmount> events = { {
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+			{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | cache },
+			{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | cache },
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+		} };
+
+		for (int i = 0; i < PerfEventAmount; i++)
+		{
+			perf_event_attr attributes;
+			std::memset(&attributes, 0, sizeof(attributes));
+			attributes.size = sizeof(attributes);
+			attributes.type = events[i].first;
+			attributes.config = events[i].second;
+			attributes.disabled = 1;
+			attributes.exclude_kernel = 1;
+			attributes.exclude_hv = 1;
+			attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+			descriptors[i] = (int)syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+		}
+#endif
+	}
+
+	~PerfCounters()
+	{
+#ifdef __linux__
+		for (int descriptor : descriptors)
+		{
+			if (descriptor >= 0)
+			{
+				close(descriptor);
+			}
+		}
+#endif
+	}
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	bool available() const
+	{
+		for (int descriptor : descriptors)
+		{
+			if (descriptor >= 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void start()
+	{
+#ifdef __linux__
+		for (int descriptor : descriptors)
+		{
+			if (descriptor >= 0)
+			{
+				ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+				ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+#endif
+	}
+
+	// Stops counting until resume(), stop() still returns the counts of both parts.
+	void pause()
+	{
+#ifdef __linux__
+		for (int descriptor : descriptors)
+		{
+			if (descriptor >= 0)
+			{
+				ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+			}
+		}
+#endif
+	}
+
+	void resume()
+	{
+#ifdef __linux__
+		for (int descriptor : descriptors)
+		{
+			if (descriptor >= 0)
+			{
+				ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+#endif
+	}
+
+	// Counts since start(), scaled up when the kernel had to multiplex the counters.
+	PerfCounterValues stop()
+	{
+		PerfCounterValues result;
+#ifdef __linux__
+		for (int i = 0; i < PerfEventAmount; i++)
+		{
+			if (descriptors[i] < 0)
+			{
+				continue;
+			}
+
+			ioctl(descriptors[i], PERF_EVENT_IOC_DISABLE, 0);
+
+			unsigned long long data[3]; // value, time enabled, time running
+			if (read(descriptors[i], data, sizeof(data)) == sizeof(data) && data[2] > 0)
+			{
+				result.values[i] = data[2] < data[1] ? (unsigned long long)((double)data[0] * data[1] / data[2]) : data[0];
+				result.valid[i] = true;
+			}
+		}
+#endif
+		return result;
+	}
+
+	static const char* name(int event)
+	{
+		static const char* names[PerfEventAmount] = { "Cycles", "Instructions", "L1D misses", "LLC misses", "Branch misses" };
+		return names[event];
+	}
+
+private:
+	std::array<int, PerfEventAmount> descriptors;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "Search.h"
+
+// Leaf nodes exactly depth plies below the state. Finished games have no children.
+inline unsigned long long perft(State& state, int depth)
+{
+	if (depth == 0)
+	{
+		return 1;
+	}
+	if (state.moves.empty())
+	{
+		state.makeMove(10, 10);
+		unsigned long long nodes = perft(state, depth - 1);
+		state.undoMove();
+		return nodes;
+	}
+	if (state.isEndGame())
+	{
+		return 0;
+	}
+
+	unsigned long long nodes = 0;
+	for (int i = 0; i < (int)state.freeSpots.size(); i++)
+	{
+		if (state.freeSpots[i].moveIndex > 0)
+		{
+			if (depth == 1)
+			{
+				nodes++;
+				continue;
+			}
+
+			Check(StateHash before = state.stateHash);
+			Check(size_t freeSpotsBefore = state.freeSpots.size());
+
+			state.makeMove(state.freeSpots[i].location.x, state.freeSpots[i].location.y);
+			nodes += perft(state, depth - 1);
+			state.undoMove();
+
+			Check(if (before < state.stateHash || state.stateHash < before || freeSpotsBefore != state.freeSpots.size())
+				throw std::logic_error("undoMove did not restore the state"));
+		}
+	}
+
+	return nodes;
+}
+
+struct PerftDivide
+{
+	Location location;
+	unsigned long long nodes;
+};
+
+// perft split over threads at the root, one result per root move in freeSpots order.
+// State cannot be copied, so every thread replays the moves on its own state.
+inline std::vector<PerftDivide> perftDivide(const std::vector<Location>& moves, int depth, int threads)
+{
+	State root;
+	playMoves(root, moves);
+
+	std::vector<PerftDivide> divide;
+	if (depth <= 0 || (!root.moves.empty() && root.isEndGame()))
+	{
+		return divide;
+	}
+
+	if (root.moves.empty())
+	{
+		divide.push_back({ { 10, 10 }, 0 });
+	}
+	for (const auto& freeSpot : root.freeSpots)
+	{
+		if (freeSpot.moveIndex > 0)
+		{
+			divide.push_back({ freeSpot.location, 0 });
+		}
+	}
+
+	std::atomic<int> next(0);
+	auto worker = [&]()
+	{
+		State state;
+		playMoves(state, moves);
+
+		for (int i = next++; i < (int)divide.size(); i = next++)
+		{
+			state.makeMove(divide[i].location.x, divide[i].location.y);
+			divide[i].nodes = perft(state, depth - 1);
+			state.undoMove();
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (int i = 1; i < threads; i++)
+	{
+		pool.emplace_back(worker);
+	}
+	worker();
+	for (auto& thread : pool)
+	{
+		thread.join();
+	}
+
+	return divide;
+}
+
+struct PerftReference
+{
+	const char* name;
+	const char* moves;
+	int depth;
+	unsigned long long nodes;
+};
+
+// Known counts, any change to makeMove, undoMove or freeSpots has to reproduce them.
+const PerftReference perftReferences[] =
+{
+	{ "start", "10,10", 5, 720 },
+	{ "start", "10,10", 10, 8769096 },
+	{ "opening", "10,10 9,9 9,10 9,11 8,11 10,9 8,9 8,10", 6, 238646 },
+	{ "circle threat", "10,10 9,9 9,10 9,11 8,11 10,9 8,9 8,10 7,11 9,12 10,8 10,11 7,9 9,8 8,12 10,12", 6, 914450 },
+	{ "middlegame", "10,10 9,9 9,10 9,11 8,11 10,9 8,9 8,10 7,11 9,12 10,8 10,11 7,9 9,8 8,12 10,12 8,13 8,8 7,8 11,12", 6, 2721661 },
+	{ "double four", "10,10 10,11 9,11 11,10 9,10 8,11 10,12 10,9 8,10 11,11 12,10 8,9 9,9 12,11 10,8 7,11 13,10 7,9 11,8 8,12 10,7 7,10 11,7 6,9", 6, 9284446 },
+	{ "circle threat 2", "10,10 11,10 10,9 11,9 9,9 12,10 10,11 11,8 9,10 10,8 12,9 9,11 10,12 10,7 12,8 9,8 8,9 11,11 9,12 11,7 8,8 11,12 8,10 12,12 12,11 13,12 10,13 13,10 13,9 11,13", 6, 3439501 },
+	{ "late", "10,10 9,9 10,9 9,10 9,11 8,9 8,10 10,11 8,11 9,8 7,9 10,12 11,10 7,11 11,9 11,11 10,8 7,10 11,8 11,12 6,11 10,7 6,10 12,8 7,12 8,8 10,13 5,11 6,12 12,10 9,13 5,12 12,12 10,14 11,13 7,8 8,7 9,14 9,7 8,12", 5, 1075150 },
+};
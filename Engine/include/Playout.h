@@ -0,0 +1,835 @@
+#pragma once
+
+#include <array>
+#include <random>
+
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "Search.h"
+
+// Random playouts on bitboards. The 271 cells are laid out in axial coordinates
+// on a 20x19 grid (the 20th column is padding), so every hex direction is a
+// plain shift: 1 along a row, 20 and 19 across rows. Word k of PlayoutBatch::Games
+// independent games is held in one Lanes value, so every bitboard operation
+// advances all games at once.
+
+#define PlayoutGridWidth 20
+#define PlayoutGridHeight 19
+#define PlayoutWords 6
+
+inline int popCount(unsigned long long x)
+{
+#ifdef _MSC_VER
+	return (int)__popcnt64(x);
+#else
+	return __builtin_popcountll(x);
+#endif
+}
+
+inline int lowestBit(unsigned long long x)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, x);
+	return (int)index;
+#else
+	return __builtin_ctzll(x);
+#endif
+}
+
+// Index of the n-th set bit of x.
+inline int selectBit(unsigned long long x, int n)
+{
+#ifdef __BMI2__
+	return lowestBit(_pdep_u64(1ull << n, x));
+#else
+	for (int i = 0; i < n; i++)
+	{
+		x &= x - 1;
+	}
+	return lowestBit(x);
+#endif
+}
+
+#ifdef __AVX2__
+
+struct Lanes
+{
+	__m256i v;
+
+	static Lanes zero()
+	{
+		return { _mm256_setzero_si256() };
+	}
+	static Lanes broadcast(unsigned long long x)
+	{
+		return { _mm256_set1_epi64x((long long)x) };
+	}
+	static Lanes load(const unsigned long long* data)
+	{
+		return { _mm256_loadu_si256((const __m256i*)data) };
+	}
+	void store(unsigned long long* data) const
+	{
+		_mm256_storeu_si256((__m256i*)data, v);
+	}
+
+	Lanes operator&(const Lanes& other) const { return { _mm256_and_si256(v, other.v) }; }
+	Lanes operator|(const Lanes& other) const { return { _mm256_or_si256(v, other.v) }; }
+	Lanes andNot(const Lanes& other) const { return { _mm256_andnot_si256(other.v, v) }; }
+
+	template<int S> Lanes shiftLeft() const { return { _mm256_slli_epi64(v, S) }; }
+	template<int S> Lanes shiftRight() const { return { _mm256_srli_epi64(v, S) }; }
+
+	// Bit i is set when lane i is non-zero.
+	int nonZeroMask() const
+	{
+		return ~_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, _mm256_setzero_si256()))) & 0xF;
+	}
+	bool operator==(const Lanes& other) const
+	{
+		return _mm256_movemask_epi8(_mm256_cmpeq_epi64(v, other.v)) == -1;
+	}
+};
+
+#else
+
+struct Lanes
+{
+	std::array<unsigned long long, 4> v;
+
+	static Lanes zero()
+	{
+		return { { 0, 0, 0, 0 } };
+	}
+	static Lanes broadcast(unsigned long long x)
+	{
+		return { { x, x, x, x } };
+	}
+	static Lanes load(const unsigned long long* data)
+	{
+		return { { data[0], data[1], data[2], data[3] } };
+	}
+	void store(unsigned long long* data) const
+	{
+		for (int i = 0; i < 4; i++) data[i] = v[i];
+	}
+
+	Lanes operator&(const Lanes& other) const { Lanes r; for (int i = 0; i < 4; i++) r.v[i] = v[i] & other.v[i]; return r; }
+	Lanes operator|(const Lanes& other) const { Lanes r; for (int i = 0; i < 4; i++) r.v[i] = v[i] | other.v[i]; return r; }
+	Lanes andNot(const Lanes& other) const { Lanes r; for (int i = 0; i < 4; i++) r.v[i] = v[i] & ~other.v[i]; return r; }
+
+	template<int S> Lanes shiftLeft() const { Lanes r; for (int i = 0; i < 4; i++) r.v[i] = S >= 64 ? 0 : v[i] << (S & 63); return r; }
+	template<int S> Lanes shiftRight() const { Lanes r; for (int i = 0; i < 4; i++) r.v[i] = S >= 64 ? 0 : v[i] >> (S & 63); return r; }
+
+	int nonZeroMask() const
+	{
+		int mask = 0;
+		for (int i = 0; i < 4; i++) if (v[i] != 0) mask |= 1 << i;
+		return mask;
+	}
+	bool operator==(const Lanes& other) const
+	{
+		return v == other.v;
+	}
+};
+
+#endif
+
+struct LaneBoard
+{
+	std::array<Lanes, PlayoutWords> w;
+
+	static LaneBoard zero()
+	{
+		LaneBoard board;
+		board.w.fill(Lanes::zero());
+		return board;
+	}
+
+	LaneBoard operator&(const LaneBoard& other) const { LaneBoard r; for (int k = 0; k < PlayoutWords; k++) r.w[k] = w[k] & other.w[k]; return r; }
+	LaneBoard operator|(const LaneBoard& other) const { LaneBoard r; for (int k = 0; k < PlayoutWords; k++) r.w[k] = w[k] | other.w[k]; return r; }
+	LaneBoard andNot(const LaneBoard& other) const { LaneBoard r; for (int k = 0; k < PlayoutWords; k++) r.w[k] = w[k].andNot(other.w[k]); return r; }
+
+	// Whole-board shift towards higher cell indices.
+	template<int S> LaneBoard up() const
+	{
+		const int words = S / 64;
+		const int bits = S % 64;
+
+		LaneBoard r;
+		for (int k = 0; k < PlayoutWords; k++)
+		{
+			Lanes low = k - words >= 0 ? w[k - words].template shiftLeft<bits>() : Lanes::zero();
+			Lanes high = k - words - 1 >= 0 ? w[k - words - 1].template shiftRight<64 - bits>() : Lanes::zero();
+			r.w[k] = low | high;
+		}
+		return r;
+	}
+	// Whole-board shift towards lower cell indices.
+	template<int S> LaneBoard down() const
+	{
+		const int words = S / 64;
+		const int bits = S % 64;
+
+		LaneBoard r;
+		for (int k = 0; k < PlayoutWords; k++)
+		{
+			Lanes low = k + words < PlayoutWords ? w[k + words].template shiftRight<bits>() : Lanes::zero();
+			Lanes high = k + words + 1 < PlayoutWords ? w[k + words + 1].template shiftLeft<64 - bits>() : Lanes::zero();
+			r.w[k] = low | high;
+		}
+		return r;
+	}
+
+	// Every cell adjacent to a set cell. Padding and corner cells must be masked by the caller.
+	LaneBoard neighbours() const
+	{
+		return up<1>() | down<1>()
+			| up<PlayoutGridWidth>() | down<PlayoutGridWidth>()
+			| up<PlayoutGridWidth - 1>() | down<PlayoutGridWidth - 1>();
+	}
+
+	// Bit i is set when lane i contains five set cells in a row.
+	int fiveInARowMask() const
+	{
+		return fiveInARow<1>() | fiveInARow<PlayoutGridWidth>() | fiveInARow<PlayoutGridWidth - 1>();
+	}
+	template<int S> int fiveInARow() const
+	{
+		LaneBoard two = *this & down<S>();
+		LaneBoard four = two & two.template down<2 * S>();
+		LaneBoard five = four & down<4 * S>();
+		return five.nonZeroMask();
+	}
+
+	int nonZeroMask() const
+	{
+		Lanes any = w[0];
+		for (int k = 1; k < PlayoutWords; k++) any = any | w[k];
+		return any.nonZeroMask();
+	}
+	bool operator==(const LaneBoard& other) const
+	{
+		for (int k = 0; k < PlayoutWords; k++)
+		{
+			if (!(w[k] == other.w[k])) return false;
+		}
+		return true;
+	}
+};
+
+class PlayoutGeometry
+{
+public:
+	PlayoutGeometry()
+	{
+		Board board;
+
+		for (int i = 0; i < XSIZE; i++)
+		{
+			for (int j = 0; j < YSIZE; j++)
+			{
+				cell[i][j] = -1;
+			}
+		}
+
+		std::array<unsigned long long, PlayoutWords> inBounds = {};
+		for (auto location : board.reverseLinearIndex)
+		{
+			// Offset coordinates with odd rows shifted right, to axial coordinates centred on (10, 10).
+			int q = location.x - (location.y - (location.y & 1)) / 2 - 5 + 9;
+			int r = location.y - 10 + 9;
+			assert(0 <= q && q < PlayoutGridWidth - 1 && 0 <= r && r < PlayoutGridHeight);
+
+			int index = r * PlayoutGridWidth + q;
+			cell[location.x][location.y] = index;
+			locations[index] = location;
+			inBounds[index / 64] |= 1ull << (index % 64);
+		}
+
+		std::array<unsigned long long, PlayoutWords> edge = {};
+		for (auto location : board.reverseLinearIndex)
+		{
+			for (auto neighbour : board.neighbours[location.x][location.y])
+			{
+				if (!board.inBounds[neighbour.x][neighbour.y])
+				{
+					int index = cell[location.x][location.y];
+					edge[index / 64] |= 1ull << (index % 64);
+				}
+			}
+		}
+
+		for (auto location : board.reverseLinearIndex)
+		{
+			std::array<unsigned long long, PlayoutWords>& touched = neighbourWords[cell[location.x][location.y]];
+			touched.fill(0);
+			for (auto neighbour : board.neighbours[location.x][location.y])
+			{
+				if (board.inBounds[neighbour.x][neighbour.y])
+				{
+					int index = cell[neighbour.x][neighbour.y];
+					touched[index / 64] |= 1ull << (index % 64);
+				}
+			}
+		}
+
+		for (int k = 0; k < PlayoutWords; k++)
+		{
+			mask.w[k] = Lanes::broadcast(inBounds[k]);
+			edgeMask.w[k] = Lanes::broadcast(edge[k]);
+		}
+	}
+
+	static const PlayoutGeometry& get()
+	{
+		static const PlayoutGeometry geometry;
+		return geometry;
+	}
+
+	int cell[XSIZE][YSIZE];
+	std::array<Location, PlayoutWords * 64> locations;
+	std::array<std::array<unsigned long long, PlayoutWords>, PlayoutWords * 64> neighbourWords;
+
+	LaneBoard mask;
+	LaneBoard edgeMask;
+};
+
+// PlayoutBatch::Games random games from the same position, played in lockstep.
+// Only five in a row is tested while playing; enclosures are monotone (stones are
+// never removed), so they are found once at the end and the first is dated by
+// bisection. Only when the other player made it by moving into a hole are the later
+// moves tested one by one.
+class PlayoutBatch
+{
+public:
+	static const int Games = 4;
+
+	PlayoutBatch(const State& state, unsigned long long seed)
+		: geometry(PlayoutGeometry::get())
+	{
+		stones[0] = LaneBoard::zero();
+		stones[1] = LaneBoard::zero();
+		ones = LaneBoard::zero();
+		twos = LaneBoard::zero();
+
+		startPly = (int)state.moves.size();
+		ply = startPly;
+		player = state.player;
+
+		for (int ln = 0; ln < Games; ln++)
+		{
+			for (int i = 0; i < startPly; i++)
+			{
+				history[ln][i] = geometry.cell[state.moves[i].location.x][state.moves[i].location.y];
+			}
+
+			rng[ln] = seed + 0x9E3779B97F4A7C15ull * (ln + 1);
+			winner[ln] = Player::Empty;
+			winPly[ln] = -1;
+			length[ln] = startPly;
+		}
+
+		for (int i = 0; i < startPly; i++)
+		{
+			int index = geometry.cell[state.moves[i].location.x][state.moves[i].location.y];
+			addStone(state.moves[i].player, singleCell(index), touchedCells(index));
+		}
+
+		finished = 0;
+		if (startPly > 0 && state.isEndGame())
+		{
+			finished = (1 << Games) - 1;
+			for (int ln = 0; ln < Games; ln++)
+			{
+				winner[ln] = getOtherPlayer(state.player);
+				winPly[ln] = startPly - 1;
+			}
+		}
+	}
+
+	void run()
+	{
+		while (finished != (1 << Games) - 1 && ply < (int)history[0].size())
+		{
+			step();
+		}
+		finished = (1 << Games) - 1;
+
+		resolveCircles();
+	}
+
+	// Player::Empty for a draw.
+	Player getWinner(int lane) const
+	{
+		return winner[lane];
+	}
+
+	int getLength(int lane) const
+	{
+		return (winPly[lane] >= 0 ? winPly[lane] + 1 : length[lane]) - startPly;
+	}
+
+	// The moves played in lane, up to and including the winning move.
+	std::vector<Location> getMoves(int lane) const
+	{
+		std::vector<Location> moves;
+		for (int i = startPly; i < startPly + getLength(lane); i++)
+		{
+			moves.push_back(geometry.locations[history[lane][i]]);
+		}
+		return moves;
+	}
+
+private:
+	void step()
+	{
+		LaneBoard occupied = stones[0] | stones[1];
+		LaneBoard legal;
+		if (ply == 0)
+		{
+			legal = singleCell(geometry.cell[10][10]);
+		}
+		else if (ply == 1)
+		{
+			legal = (ones & geometry.mask).andNot(occupied);
+		}
+		else
+		{
+			legal = (twos & geometry.mask).andNot(occupied);
+		}
+
+		alignas(32) unsigned long long words[PlayoutWords][Games];
+		for (int k = 0; k < PlayoutWords; k++)
+		{
+			legal.w[k].store(words[k]);
+		}
+
+		alignas(32) unsigned long long moveWords[PlayoutWords][Games] = {};
+		alignas(32) unsigned long long touchedWords[PlayoutWords][Games] = {};
+		for (int ln = 0; ln < Games; ln++)
+		{
+			if (finished & (1 << ln))
+			{
+				continue;
+			}
+
+			int counts[PlayoutWords];
+			int total = 0;
+			for (int k = 0; k < PlayoutWords; k++)
+			{
+				counts[k] = popCount(words[k][ln]);
+				total += counts[k];
+			}
+			if (total == 0)
+			{
+				finished |= 1 << ln;
+				length[ln] = ply;
+				continue;
+			}
+
+			int pick = (int)((nextRandom(ln) * total) >> 32);
+			int k = 0;
+			while (pick >= counts[k])
+			{
+				pick -= counts[k];
+				k++;
+			}
+			int bit = selectBit(words[k][ln], pick);
+
+			moveWords[k][ln] = 1ull << bit;
+			history[ln][ply] = k * 64 + bit;
+			for (int n = 0; n < PlayoutWords; n++)
+			{
+				touchedWords[n][ln] = geometry.neighbourWords[k * 64 + bit][n];
+			}
+		}
+
+		LaneBoard move, touched;
+		for (int k = 0; k < PlayoutWords; k++)
+		{
+			move.w[k] = Lanes::load(moveWords[k]);
+			touched.w[k] = Lanes::load(touchedWords[k]);
+		}
+		addStone(player, move, touched);
+
+		int five = stones[player].fiveInARowMask() & ~finished;
+		for (int ln = 0; ln < Games; ln++)
+		{
+			if (five & (1 << ln))
+			{
+				winner[ln] = player;
+				winPly[ln] = ply;
+			}
+		}
+		finished |= five;
+
+		for (int ln = 0; ln < Games; ln++)
+		{
+			if (!(finished & (1 << ln))) length[ln] = ply + 1;
+		}
+
+		ply++;
+		player = getOtherPlayer(player);
+	}
+
+	void addStone(Player p, const LaneBoard& move, const LaneBoard& touched)
+	{
+		stones[p] = stones[p] | move;
+		twos = twos | (ones & touched);
+		ones = ones | touched;
+	}
+
+	// The cells of within connected to the cells of reached.
+	LaneBoard fill(LaneBoard reached, const LaneBoard& within) const
+	{
+		while (true)
+		{
+			LaneBoard next = (reached | reached.neighbours()) & within;
+			if (next == reached)
+			{
+				return reached;
+			}
+			reached = next;
+		}
+	}
+
+	// Bit i is set when, in lane i, the stones of p enclose a stone of the other player.
+	int enclosureMask(const LaneBoard& own, const LaneBoard& other) const
+	{
+		LaneBoard open = geometry.mask.andNot(own);
+		return other.andNot(fill(geometry.edgeMask & open, open)).nonZeroMask();
+	}
+
+	// The stones of p and of the other player after plies[i] in lane i, none for -1.
+	void stonesAt(Player p, const std::array<int, Games>& plies, LaneBoard& own, LaneBoard& other) const
+	{
+		alignas(32) unsigned long long words[2][PlayoutWords][Games] = {};
+		for (int ln = 0; ln < Games; ln++)
+		{
+			for (int i = 0; i <= plies[ln]; i++)
+			{
+				int index = history[ln][i];
+				Player mover = i % 2 == 0 ? Player::P1 : Player::P2;
+				words[mover == p ? 0 : 1][index / 64][ln] |= 1ull << (index % 64);
+			}
+		}
+
+		for (int k = 0; k < PlayoutWords; k++)
+		{
+			own.w[k] = Lanes::load(words[0][k]);
+			other.w[k] = Lanes::load(words[1][k]);
+		}
+	}
+
+	int enclosureMaskAt(Player p, const std::array<int, Games>& plies) const
+	{
+		LaneBoard own, other;
+		stonesAt(p, plies, own, other);
+		return enclosureMask(own, other);
+	}
+
+	// Bit i is set when, in lane i, the move at plies[i] borders a hole in the stones of p
+	// that holds a stone of the other player, the test of State::makesCircle. Lanes at -1
+	// are left out.
+	int circleMaskAt(Player p, const std::array<int, Games>& plies) const
+	{
+		LaneBoard own, other;
+		stonesAt(p, plies, own, other);
+		LaneBoard open = geometry.mask.andNot(own);
+		LaneBoard holes = open.andNot(fill(geometry.edgeMask & open, open));
+		LaneBoard captured = fill(other & holes, holes);
+
+		alignas(32) unsigned long long words[PlayoutWords][Games] = {};
+		for (int ln = 0; ln < Games; ln++)
+		{
+			for (int k = 0; k < PlayoutWords && plies[ln] >= 0; k++)
+			{
+				words[k][ln] = geometry.neighbourWords[history[ln][plies[ln]]][k];
+			}
+		}
+		LaneBoard touched;
+		for (int k = 0; k < PlayoutWords; k++)
+		{
+			touched.w[k] = Lanes::load(words[k]);
+		}
+		return (captured & touched).nonZeroMask();
+	}
+
+	void resolveCircles()
+	{
+		for (Player p : { Player::P1, Player::P2 })
+		{
+			int circles = enclosureMask(stones[p], stones[getOtherPlayer(p)]);
+			if (circles == 0)
+			{
+				continue;
+			}
+
+			// Earliest ply at which p encloses a stone of the other player.
+			std::array<int, Games> low, high;
+			for (int ln = 0; ln < Games; ln++)
+			{
+				low[ln] = 0;
+				high[ln] = (winPly[ln] >= 0 ? winPly[ln] : length[ln] - 1);
+			}
+
+			bool searching = true;
+			while (searching)
+			{
+				searching = false;
+				std::array<int, Games> middle;
+				for (int ln = 0; ln < Games; ln++)
+				{
+					middle[ln] = (low[ln] + high[ln]) / 2;
+					if (low[ln] < high[ln] && (circles & (1 << ln))) searching = true;
+				}
+				if (!searching)
+				{
+					break;
+				}
+
+				int found = enclosureMaskAt(p, middle);
+				for (int ln = 0; ln < Games; ln++)
+				{
+					if (low[ln] >= high[ln]) continue;
+					if (found & (1 << ln)) high[ln] = middle[ln];
+					else low[ln] = middle[ln] + 1;
+				}
+			}
+
+			// That is the circle when p made it. When the other player moved into a hole
+			// instead, the game went on and the circle is the first later move of p that
+			// borders a hole with a stone of the other player, like State::makesCircle.
+			int scanning = 0;
+			std::array<int, Games> circlePly, plies, last;
+			for (int ln = 0; ln < Games; ln++)
+			{
+				circlePly[ln] = -1;
+				plies[ln] = -1;
+				last[ln] = (winPly[ln] >= 0 ? winPly[ln] - 1 : length[ln] - 1);
+				if (!(circles & (1 << ln)))
+				{
+					continue;
+				}
+
+				Player mover = high[ln] % 2 == 0 ? Player::P1 : Player::P2;
+				if (mover == p && high[ln] >= startPly)
+				{
+					circlePly[ln] = high[ln];
+					continue;
+				}
+				plies[ln] = (std::max)(high[ln] + 1, startPly);
+				if ((plies[ln] % 2 == 0 ? Player::P1 : Player::P2) != p)
+				{
+					plies[ln]++;
+				}
+				if (plies[ln] <= last[ln])
+				{
+					scanning |= 1 << ln;
+				}
+				else
+				{
+					plies[ln] = -1;
+				}
+			}
+
+			while (scanning != 0)
+			{
+				int found = circleMaskAt(p, plies);
+				for (int ln = 0; ln < Games; ln++)
+				{
+					if (!(scanning & (1 << ln))) continue;
+					if (found & (1 << ln))
+					{
+						circlePly[ln] = plies[ln];
+					}
+					plies[ln] += 2;
+					if ((found & (1 << ln)) || plies[ln] > last[ln])
+					{
+						scanning &= ~(1 << ln);
+						plies[ln] = -1;
+					}
+				}
+			}
+
+			for (int ln = 0; ln < Games; ln++)
+			{
+				if (circlePly[ln] >= 0 && (winPly[ln] < 0 || circlePly[ln] < winPly[ln]))
+				{
+					winner[ln] = p;
+					winPly[ln] = circlePly[ln];
+				}
+			}
+		}
+	}
+
+	LaneBoard singleCell(int index) const
+	{
+		LaneBoard board = LaneBoard::zero();
+		board.w[index / 64] = Lanes::broadcast(1ull << (index % 64));
+		return board;
+	}
+
+	LaneBoard touchedCells(int index) const
+	{
+		LaneBoard board;
+		for (int k = 0; k < PlayoutWords; k++)
+		{
+			board.w[k] = Lanes::broadcast(geometry.neighbourWords[index][k]);
+		}
+		return board;
+	}
+
+	unsigned long long nextRandom(int lane)
+	{
+		// xorshift64*
+		unsigned long long& x = rng[lane];
+		x ^= x >> 12;
+		x ^= x << 25;
+		x ^= x >> 27;
+		return (x * 0x2545F4914F6CDD1Dull) >> 32;
+	}
+
+	const PlayoutGeometry& geometry;
+
+	LaneBoard stones[2];
+	LaneBoard ones;
+	LaneBoard twos;
+
+	int startPly;
+	int ply;
+	Player player;
+	int finished;
+
+	std::array<std::array<int, 271>, Games> history;
+	std::array<unsigned long long, Games> rng;
+	std::array<Player, Games> winner;
+	std::array<int, Games> winPly;
+	std::array<int, Games> length;
+};
+
+// Plays amount random games from state and counts the results, indexed by Player.
+inline std::array<int, 3> runPlayouts(const State& state, int amount, unsigned long long seed)
+{
+	std::array<int, 3> results = { 0, 0, 0 };
+
+	for (int i = 0; i < amount; i += PlayoutBatch::Games)
+	{
+		PlayoutBatch batch(state, seed + i);
+		batch.run();
+
+		for (int ln = 0; ln < PlayoutBatch::Games && i + ln < amount; ln++)
+		{
+			results[batch.getWinner(ln)]++;
+		}
+	}
+
+	return results;
+}
+
+// Replays amount bitboard games from state through State::makeMove and counts the games
+// they disagree on: a move that is not legal there, a game that ends at another ply, or
+// another result. Leaves the state unchanged.
+inline int playoutMismatches(State& state, int amount, unsigned long long seed)
+{
+	int mismatches = 0;
+	for (int i = 0; i < amount; i += PlayoutBatch::Games)
+	{
+		PlayoutBatch batch(state, seed + i);
+		batch.run();
+
+		for (int ln = 0; ln < PlayoutBatch::Games && i + ln < amount; ln++)
+		{
+			auto moves = batch.getMoves(ln);
+			int played = 0;
+			bool agree = true;
+			for (const auto& location : moves)
+			{
+				bool legal = state.moves.empty() ? location == Location{ 10, 10 } : !state.isEndGame() && state.isFreeSpot(location.x, location.y);
+				if (!legal)
+				{
+					agree = false;
+					break;
+				}
+				state.makeMove(location.x, location.y);
+				played++;
+			}
+
+			if (agree)
+			{
+				bool ended = !state.moves.empty() && state.isEndGame();
+				Player winner = ended ? getOtherPlayer(state.player) : Player::Empty;
+				bool blocked = true;
+				for (const auto& freeSpot : state.freeSpots)
+				{
+					blocked = blocked && freeSpot.moveIndex <= 0;
+				}
+				agree = winner == batch.getWinner(ln) && (ended || blocked);
+			}
+			mismatches += !agree;
+
+			while (played-- > 0)
+			{
+				state.undoMove();
+			}
+		}
+	}
+	return mismatches;
+}
+
+// Reference playout through State::makeMove, leaves the state unchanged. On an empty
+// board it opens at the centre like PlayoutBatch.
+inline Player randomPlayout(State& state, std::mt19937& gen)
+{
+	int played = 0;
+	Player winner = Player::Empty;
+	if (state.moves.empty())
+	{
+		state.makeMove(10, 10);
+		played++;
+	}
+
+	while (!state.isEndGame())
+	{
+		int free = 0;
+		for (int i = 0; i < (int)state.freeSpots.size(); i++)
+		{
+			if (state.freeSpots[i].moveIndex > 0) free++;
+		}
+		if (free == 0)
+		{
+			break;
+		}
+
+		int pick = std::uniform_int_distribution<>(0, free - 1)(gen);
+		for (int i = 0; i < (int)state.freeSpots.size(); i++)
+		{
+			if (state.freeSpots[i].moveIndex > 0 && pick-- == 0)
+			{
+				state.makeMove(state.freeSpots[i].location.x, state.freeSpots[i].location.y);
+				played++;
+				break;
+			}
+		}
+	}
+
+	if (!state.moves.empty() && state.isEndGame())
+	{
+		winner = getOtherPlayer(state.player);
+	}
+
+	while (played-- > 0)
+	{
+		state.undoMove();
+	}
+
+	return winner;
+}
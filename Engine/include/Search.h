@@ -0,0 +1,1848 @@
+#pragma once
+
+#include <vector>
+#include <stdexcept>
+#include <cassert>
+#include <array>
+#include <random>
+#include <sstream> 
+#include <map>
+#include <algorithm>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <new>
+#include <thread>
+
+#include "SearchStats.h"
+#include "Instrumentation.h"
+#include "Profiler.h"
+#include "LargePages.h"
+#include "Numa.h"
+
+#define CheckStatePersistence
+
+#ifdef CheckStatePersistence
+#define Check(x) x
+#else
+#define Check(x)
+#endif
+
+enum Player
+{
+	P1, P2, Empty
+};
+
+enum Side
+{
+	right, topRight, topLeft, left, bottomLeft, bottomRight
+};
+
+enum ValueType
+{
+	Exact, Lower, Upper
+};
+
+#define MaxScore 800
+#define MaxPly 128
+
+// Search scores of won and lost positions are MaxScore minus the plies to the end of
+// the game, so the search prefers the fastest win and the slowest loss. Heuristic
+// evaluations stay well below WinScoreBound.
+#define WinScoreBound (MaxScore - MaxPly)
+
+inline bool isDecided(int value)
+{
+	return value >= WinScoreBound || value <= -WinScoreBound;
+}
+
+// The table stores the distance to the end of the game from the stored position, the
+// search uses the distance from the root.
+inline int scoreToTable(int value, int ply)
+{
+	return value >= WinScoreBound ? value + ply : value <= -WinScoreBound ? value - ply : value;
+}
+
+inline int scoreFromTable(int value, int ply)
+{
+	return value >= WinScoreBound ? value - ply : value <= -WinScoreBound ? value + ply : value;
+}
+
+#define XSIZE 21
+#define YSIZE 21
+
+inline Player getOtherPlayer(Player player)
+{
+	if (player == Player::P1)
+	{
+		return Player::P2;
+	}
+	else
+	{
+		return Player::P1;
+	}
+}
+
+struct Location
+{
+	int x;
+	int y;
+
+	bool operator==(const Location& other) const
+	{
+		return x == other.x && y == other.y;
+	};
+};
+
+struct StaticLocation
+{
+	Player player;
+	int moveIndex;
+	int freeSpotsIndex;
+	int amountNeighbours;
+
+	bool operator==(const StaticLocation& other) const
+	{
+		return player == other.player 
+			&& moveIndex == other.moveIndex
+			&& freeSpotsIndex == other.freeSpotsIndex
+			&& amountNeighbours == other.amountNeighbours;
+	};
+};
+
+struct Move
+{
+	Location location;
+	Player player;
+
+	bool operator==(const Move& other) const
+	{
+		return location == other.location && player == other.player;
+	};
+};
+
+struct FreeSpot
+{
+	Location location;
+	int moveIndex;
+
+	bool operator==(const FreeSpot& other) const
+	{
+		return location == other.location && moveIndex == other.moveIndex;
+	};
+};
+
+struct Score
+{
+	int straithP1 = 0;
+	int straithP2 = 0;
+
+	bool hasCircleP1 = false;
+	bool hasCircleP2 = false;
+	
+	int hasPossibleStraithP1 = 0;
+	int hasPossibleStraithP2 = 0;
+
+	bool operator==(const Score& other) const
+	{
+		return straithP1 == other.straithP1
+			&& straithP2 == other.straithP2
+			&& hasCircleP1 == other.hasCircleP1
+			&& hasCircleP2 == other.hasCircleP2;
+	};
+};
+
+class Board
+{
+public:
+	Board()
+	{
+		calcNeighbours();
+		calcBounds();
+		calcLinearIndex();
+		calcRows();
+	}
+
+	void calcNeighbours()
+	{
+		for (int i = 0; i < XSIZE; i++)
+		{
+			for (int j = 0; j < YSIZE; j++)
+			{
+				if (i > 0) neighbours[i][j][Side::left] = { i - 1, j };
+				if (i < XSIZE-1) neighbours[i][j][Side::right] = { i + 1, j };
+
+				if (j > 0)
+				{
+					if (j % 2 == 0)
+					{
+						if (i > 0) neighbours[i][j][Side::topLeft] = { i - 1, j - 1 };
+						neighbours[i][j][Side::topRight] = { i, j - 1 };
+					}
+					else
+					{
+						neighbours[i][j][Side::topLeft] = { i, j - 1 };
+						if (i < XSIZE-1) neighbours[i][j][Side::topRight] = { i + 1, j - 1 };
+					}
+				}
+
+				if (j < YSIZE-1)
+				{
+					if (j % 2 == 0)
+					{
+						if (i > 0) neighbours[i][j][Side::bottomLeft] = { i - 1, j + 1 };
+						neighbours[i][j][Side::bottomRight] = { i, j + 1 };
+					}
+					else
+					{
+						neighbours[i][j][Side::bottomLeft] = { i, j + 1 };
+						if (i < XSIZE-1) neighbours[i][j][Side::bottomRight] = { i + 1, j + 1 };
+					}
+				}
+			}
+		}
+	};
+	void calcBounds()
+	{
+		for (int i = 0; i < XSIZE; i++)
+		{
+			for (int j = 0; j < YSIZE; j++)
+			{
+				inBounds[i][j] = true;
+
+				if (j == 0 || j == YSIZE - 1) // top and bottom row
+				{
+					inBounds[i][j] = false;
+				}
+
+				if ((j % 2 == 0 && i + j / 2 < 6) || (j % 2 == 1 && i + j / 2 < 5)) // top left
+				{
+					inBounds[i][j] = false;
+				}
+
+				if (i - j / 2 < -4) // bottom left
+				{
+					inBounds[i][j] = false;
+				}
+
+				if (j / 2 - i < -14) // top right
+				{
+					inBounds[i][j] = false;
+				}
+
+				if ((j % 2 == 0 && i + j / 2 > 24) || (j % 2 == 1 && i + j / 2 > 23)) // bottom right
+				{
+					inBounds[i][j] = false;
+				}
+			}
+		}		
+	}
+	void calcLinearIndex()
+	{
+		// 271
+		for (int i = 0; i < XSIZE; i++)
+		{
+			for (int j = 0; j < YSIZE; j++)
+			{
+				if (inBounds[i][j])
+				{
+					linearIndex[i][j] = amount;
+					reverseLinearIndex.push_back({ i, j });
+					amount++;
+				}
+			}
+		}
+	}
+	void calcRows()
+	{
+		// 585
+		for (auto location : reverseLinearIndex)
+		{
+			for (auto dir : { left, bottomLeft, bottomRight })
+			{
+				std::vector<Location> row;
+				row.push_back(location);
+				while (row.size() < 5)
+				{
+					Location next = neighbours[row.back().x][row.back().y][dir];
+					if (!inBounds[next.x][next.y])
+					{
+						break;
+					}
+					row.push_back(next);
+				}
+				if (row.size() == 5)
+				{
+					allRows.push_back(row);
+				}
+			}
+		}
+	}
+
+	std::array<Location, 6> neighbours[XSIZE][YSIZE];
+	int linearIndex[XSIZE][YSIZE];
+	std::vector<Location> reverseLinearIndex;
+
+	bool inBounds[XSIZE][YSIZE];
+	int amount = 0;
+
+	std::vector<std::vector<Location>> allRows;
+};
+
+#define SymmetryAmount 12
+// Positions with more stones rarely meet an image of themselves, they keep the plain key.
+#define SymmetricStones 16
+
+// The 12 symmetries of the board around the centre (10, 10): 6 rotations, each also
+// mirrored. Odd rows are shifted half a cell to the right, so in axial coordinates
+// q = x - y / 2, r = y a rotation by 60 degrees maps (q, r) to (-r, q + r) and swapping
+// q and r mirrors. Cells outside the board map to themselves.
+class BoardSymmetries
+{
+public:
+	BoardSymmetries()
+	{
+		Board board;
+		for (int symmetry = 0; symmetry < SymmetryAmount; symmetry++)
+		{
+			for (int i = 0; i < 320; i++)
+			{
+				cells[symmetry][i] = i;
+			}
+			for (int x = 0; x < XSIZE; x++)
+			{
+				for (int y = 0; y < YSIZE; y++)
+				{
+					locations[symmetry][x][y] = { x, y };
+					if (!board.inBounds[x][y])
+					{
+						continue;
+					}
+
+					int q = x - y / 2 - 5;
+					int r = y - 10;
+					for (int i = 0; i < symmetry % 6; i++)
+					{
+						int rotated = -r;
+						r = q + r;
+						q = rotated;
+					}
+					if (symmetry >= 6)
+					{
+						std::swap(q, r);
+					}
+
+					Location location = { q + 5 + (r + 10) / 2, r + 10 };
+					assert(board.inBounds[location.x][location.y]);
+					locations[symmetry][x][y] = location;
+					cells[symmetry][board.linearIndex[x][y]] = board.linearIndex[location.x][location.y];
+				}
+			}
+		}
+
+		for (int symmetry = 0; symmetry < SymmetryAmount; symmetry++)
+		{
+			for (int other = 0; other < SymmetryAmount; other++)
+			{
+				Location once = apply(symmetry, { 11, 10 });
+				Location twice = apply(symmetry, { 10, 11 });
+				if (apply(other, once) == Location{ 11, 10 } && apply(other, twice) == Location{ 10, 11 })
+				{
+					inverses[symmetry] = other;
+				}
+			}
+		}
+	}
+
+	Location apply(int symmetry, Location location) const
+	{
+		return locations[symmetry][location.x][location.y];
+	}
+
+	// Linear index of the cell that linear index cell maps to.
+	int cell(int symmetry, int cell) const
+	{
+		return cells[symmetry][cell];
+	}
+
+	int inverse(int symmetry) const
+	{
+		return inverses[symmetry];
+	}
+
+private:
+	Location locations[SymmetryAmount][XSIZE][YSIZE];
+	int cells[SymmetryAmount][320];
+	int inverses[SymmetryAmount];
+};
+
+inline const BoardSymmetries boardSymmetries;
+
+// Random key per player and cell, fixed seed so keys are the same in every run.
+inline std::array<std::array<unsigned long long, 320>, 2> makeZobristKeys()
+{
+	std::mt19937_64 gen(0x416e64616e74696eull);
+	std::array<std::array<unsigned long long, 320>, 2> keys;
+	for (auto& player : keys)
+	{
+		for (auto& key : player)
+		{
+			key = gen();
+		}
+	}
+	return keys;
+}
+
+inline const std::array<std::array<unsigned long long, 320>, 2> zobristKeys = makeZobristKeys();
+
+// The stones of both players as bits, and their Zobrist key for the transposition table.
+// The side to move follows from the amount of stones, so it needs no key of its own.
+// Up to SymmetricStones stones the key of every symmetric image of the position is kept
+// up to date as well and key is the lowest of them, so all images share their table and
+// evaluation cache entries. symmetry maps the position onto the image with that key,
+// moves stored under key are moves of that image. With more stones only the plain key
+// changes, stones are taken back in the order they were set so the image keys of the
+// position with SymmetricStones stones are still right when the search returns there.
+class StateHash
+{
+public:
+	StateHash() : data({0,0,0,0,0,0,0,0,0,0})
+	{
+		keys.fill(0);
+	}
+
+	// Key after a stone of p on bit, without setting it.
+	unsigned long long keyWith(Player p, int bit) const
+	{
+		unsigned long long lowest = keys[0] ^ zobristKeys[p == Player::P2][bit];
+		for (int symmetry = 1; symmetry < SymmetryAmount && stones < SymmetricStones; symmetry++)
+		{
+			lowest = (std::min)(lowest, keys[symmetry] ^ zobristKeys[p == Player::P2][boardSymmetries.cell(symmetry, bit)]);
+		}
+		return lowest;
+	}
+
+	void set(Player p, int bit)
+	{
+		stones++;
+		toggle(p, bit);
+		selectKey();
+
+		int index = bit / 64;
+		bit -= index * 64;
+		if (p == Player::P2)
+		{
+			index += 5;
+		}
+
+		data[index] |= 1ull << bit;
+	}
+
+	void unset(Player p, int bit)
+	{
+		toggle(p, bit);
+		stones--;
+		selectKey();
+
+		int index = bit / 64;
+		bit -= index * 64;
+		if (p == Player::P2)
+		{
+			index += 5;
+		}
+
+		data[index] &= ~(1ull << bit);
+	}
+
+	bool get(Player p, int bit)
+	{
+		int index = bit / 64;
+		bit -= index * 64;
+		if (p == Player::P2)
+		{
+			index += 5;
+		}
+
+		return data[index] & (1ull << bit);
+	}
+
+	std::array<unsigned long long, 10> data;
+	unsigned long long key = 0;
+	int symmetry = 0;
+	std::array<unsigned long long, SymmetryAmount> keys;
+	int stones = 0;
+
+private:
+	// stones counts the toggled stone.
+	void toggle(Player p, int bit)
+	{
+		for (int i = 0; i < SymmetryAmount && (i == 0 || stones <= SymmetricStones); i++)
+		{
+			keys[i] ^= zobristKeys[p == Player::P2][boardSymmetries.cell(i, bit)];
+		}
+	}
+
+	void selectKey()
+	{
+		key = keys[0];
+		symmetry = 0;
+		for (int i = 1; i < SymmetryAmount && stones <= SymmetricStones; i++)
+		{
+			if (keys[i] < key)
+			{
+				key = keys[i];
+				symmetry = i;
+			}
+		}
+	}
+};
+
+inline bool operator<(const StateHash& left, const StateHash& right)
+{
+	return left.data < right.data;
+}
+
+struct StateTreeResult
+{
+	StateTreeResult(int _value, int _nodesVisited = 1, int _move = -1)
+	{
+		value = _value;
+		nodesVisited = _nodesVisited;
+		move = _move;
+	}
+
+	int value;
+	ValueType type = ValueType::Exact;
+	int move = -1;
+	Location moveLocation = {0, 0};
+	long nodesVisited = 1;
+	int depth = 0;
+};
+
+class State
+{
+public:
+	State()
+	{
+		for (int i = 0; i < XSIZE; i++)
+		{
+			for (int j = 0; j < YSIZE; j++)
+			{
+				staticMoves[i][j] = { Player::Empty, -1, -1, 0};
+			}
+		}
+
+		freeSpots.push_back({ {10, 10}, 0 });
+		staticMoves[10][10].freeSpotsIndex = 0;
+	}
+
+	State(const State& other) = delete;
+
+	// Table key of the position after makeMove(x, y), without making the move.
+	unsigned long long keyAfter(int x, int y) const
+	{
+		return stateHash.keyWith(player, board.linearIndex[x][y]);
+	}
+
+	void makeMove(int x, int y)
+	{
+		Instrument(Instrumentation::count(MakeMoves));
+		Profile(MakeMove);
+		Move move = { {x, y}, player };
+		moves.push_back(move);
+		staticMoves[move.location.x][move.location.y].player = move.player;
+		staticMoves[move.location.x][move.location.y].moveIndex = moves.size() - 1;
+		stateHash.set(player, board.linearIndex[x][y]);
+
+		const int freeSpotIndex = staticMoves[move.location.x][move.location.y].freeSpotsIndex;
+		assert(freeSpotIndex >= 0);
+		freeSpots[freeSpotIndex].moveIndex = -freeSpots[freeSpotIndex].moveIndex;
+
+		moveIndex++;
+		player = getOtherPlayer(player);
+
+		if (moves.size() == 2)
+		{
+			while (freeSpots.size() > 1)
+			{
+				staticMoves[freeSpots.back().location.x][freeSpots.back().location.y].freeSpotsIndex = -1;
+				freeSpots.pop_back();
+			}
+		}
+
+		const auto& neighbours = board.neighbours[move.location.x][move.location.y];
+		for (const auto& location : neighbours)
+		{
+			if (board.inBounds[location.x][location.y])
+			{
+				staticMoves[location.x][location.y].amountNeighbours++;
+
+				if (staticMoves[location.x][location.y].player == Player::Empty)
+				{
+					if (moves.size() == 1 || staticMoves[location.x][location.y].amountNeighbours == 2)
+					{
+						freeSpots.push_back({ location, moveIndex });
+						staticMoves[location.x][location.y].freeSpotsIndex = freeSpots.size() - 1;
+					}
+				}
+			}
+		}
+
+		Score newScore;
+		if (scores.size() > 0)
+		{
+			newScore = scores.back();
+		}
+		else
+		{
+			newScore.hasPossibleStraithP1 = board.allRows.size();
+			newScore.hasPossibleStraithP2 = board.allRows.size();
+		}
+
+		int straight = partOfStraight(move.location);
+		if (move.player == Player::P1 && straight > newScore.straithP1) newScore.straithP1 = straight;
+		if (move.player == Player::P2 && straight > newScore.straithP2) newScore.straithP2 = straight;
+
+		int blocking = locationBlockingStraith(move.location);
+		if (move.player == Player::P1) newScore.hasPossibleStraithP2 -= blocking;
+		if (move.player == Player::P2) newScore.hasPossibleStraithP1 -= blocking;
+
+		if (move.player == Player::P1 && makesCircle(move.location)) newScore.hasCircleP1 = true;
+		if (move.player == Player::P2 && makesCircle(move.location)) newScore.hasCircleP2 = true;
+
+		scores.push_back(newScore);
+	}
+
+	void undoMove()
+	{
+		Profile(UndoMove);
+		scores.pop_back();
+
+		if (moves.size() == 2)
+		{
+			while (freeSpots.size() > 1)
+			{
+				staticMoves[freeSpots.back().location.x][freeSpots.back().location.y].freeSpotsIndex = -1;
+				freeSpots.pop_back();
+			}
+
+			{
+				const auto& neighbours = board.neighbours[moves.back().location.x][moves.back().location.y];
+				for (const auto& location : neighbours)
+				{
+					if (board.inBounds[location.x][location.y])
+					{
+						staticMoves[location.x][location.y].amountNeighbours--;
+					}
+				}
+			}
+
+			{
+				const auto& neighbours = board.neighbours[moves[0].location.x][moves[0].location.y];
+				for (const auto& location : neighbours)
+				{
+					if (board.inBounds[location.x][location.y])
+					{
+						freeSpots.push_back({ location, 1});
+						staticMoves[location.x][location.y].freeSpotsIndex = freeSpots.size() - 1;
+					}
+				}
+			}
+		}
+		else
+		{
+			while (freeSpots.size() > 0 && freeSpots.back().moveIndex == moveIndex)
+			{
+				staticMoves[freeSpots.back().location.x][freeSpots.back().location.y].freeSpotsIndex = -1;
+				freeSpots.pop_back();
+			}
+
+			const int freeSpotIndex = staticMoves[moves.back().location.x][moves.back().location.y].freeSpotsIndex;
+			assert(freeSpotIndex >= 0);
+			freeSpots[freeSpotIndex].moveIndex = -freeSpots[freeSpotIndex].moveIndex;
+
+			const auto& neighbours = board.neighbours[moves.back().location.x][moves.back().location.y];
+			for (const auto& location : neighbours)
+			{
+				if (board.inBounds[location.x][location.y])
+				{
+					staticMoves[location.x][location.y].amountNeighbours--;
+				}
+			}
+		}
+
+		moveIndex--;
+		player = getOtherPlayer(player);
+
+		stateHash.unset(player, board.linearIndex[moves.back().location.x][moves.back().location.y]);
+		staticMoves[moves.back().location.x][moves.back().location.y].player = Player::Empty;
+		staticMoves[moves.back().location.x][moves.back().location.y].moveIndex = -1;
+		moves.pop_back();
+	}
+
+	bool isFreeSpot(int x, int y) const
+	{
+		const int freeSpotIndex = staticMoves[x][y].freeSpotsIndex;
+		if (freeSpotIndex >= 0)
+		{
+			if (freeSpots[freeSpotIndex].moveIndex > 0)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Symmetries of the board, see BoardSymmetries, that map every stone onto a stone of
+	// the same player. The identity is left out.
+	std::vector<int> symmetries() const
+	{
+		std::vector<int> preserved;
+		for (int symmetry = 1; symmetry < SymmetryAmount; symmetry++)
+		{
+			bool same = true;
+			for (int i = 0; i < moves.size() && same; i++)
+			{
+				Location image = boardSymmetries.apply(symmetry, moves[i].location);
+				same = staticMoves[image.x][image.y].player == moves[i].player;
+			}
+			if (same)
+			{
+				preserved.push_back(symmetry);
+			}
+		}
+		return preserved;
+	}
+
+	int partOfStraight(Location location) const
+	{
+		int maxStraithLocation = 0;
+		int straight = 0;
+
+		straight = 1
+			+ expandPartOfStraight(board.neighbours[location.x][location.y][left], left, staticMoves[location.x][location.y].player)
+			+ expandPartOfStraight(board.neighbours[location.x][location.y][right], right, staticMoves[location.x][location.y].player);
+
+		if (straight > maxStraithLocation) maxStraithLocation = straight;
+
+		straight = 1
+			+ expandPartOfStraight(board.neighbours[location.x][location.y][topLeft], topLeft, staticMoves[location.x][location.y].player)
+			+ expandPartOfStraight(board.neighbours[location.x][location.y][bottomRight], bottomRight, staticMoves[location.x][location.y].player);
+
+		if (straight > maxStraithLocation) maxStraithLocation = straight;
+
+		straight = 1
+			+ expandPartOfStraight(board.neighbours[location.x][location.y][topRight], topRight, staticMoves[location.x][location.y].player)
+			+ expandPartOfStraight(board.neighbours[location.x][location.y][bottomLeft], bottomLeft, staticMoves[location.x][location.y].player);
+
+		if (straight > maxStraithLocation) maxStraithLocation = straight;
+
+		return maxStraithLocation;
+	}
+	int expandPartOfStraight(Location location, Side side, Player player) const
+	{
+		if (board.inBounds[location.x][location.y] && staticMoves[location.x][location.y].player == player)
+		{
+			return expandPartOfStraight(board.neighbours[location.x][location.y][side], side, player) + 1;
+		}
+		else
+		{
+			return 0;
+		}
+	}
+
+	int locationBlockingStraith(Location location) const
+	{
+		int blocking = 0;
+		int straight = 0;
+
+		straight = 1
+			+ expandPartOfStraightInverse(board.neighbours[location.x][location.y][left], left, staticMoves[location.x][location.y].player, 4)
+			+ expandPartOfStraightInverse(board.neighbours[location.x][location.y][right], right, staticMoves[location.x][location.y].player, 4)
+			- 4;
+
+		if (straight > 0) blocking += straight;
+
+		straight = 1
+			+ expandPartOfStraightInverse(board.neighbours[location.x][location.y][topLeft], topLeft, staticMoves[location.x][location.y].player, 4)
+			+ expandPartOfStraightInverse(board.neighbours[location.x][location.y][bottomRight], bottomRight, staticMoves[location.x][location.y].player, 4)
+			- 4;
+
+		if (straight > 0) blocking += straight;
+
+		straight = 1
+			+ expandPartOfStraightInverse(board.neighbours[location.x][location.y][topRight], topRight, staticMoves[location.x][location.y].player, 4)
+			+ expandPartOfStraightInverse(board.neighbours[location.x][location.y][bottomLeft], bottomLeft, staticMoves[location.x][location.y].player, 4)
+			- 4;
+
+		if (straight > 0) blocking += straight;
+
+		return blocking;
+	}
+	int expandPartOfStraightInverse(Location location, Side side, Player player, int limit) const
+	{
+		if (board.inBounds[location.x][location.y] && staticMoves[location.x][location.y].player != player && limit > 0)
+		{
+			return expandPartOfStraightInverse(board.neighbours[location.x][location.y][side], side, player, limit - 1) + 1;
+		}
+		else
+		{
+			return 0;
+		}
+	}
+
+	bool makesCircle(Location location) const
+	{
+		Instrument(Instrumentation::count(CircleChecks));
+		Profile(MakesCircle);
+		std::array<bool, 6> covered = {false, false, false, false, false, false};
+		
+		for (int i = 0; i < 6; i++)
+		{
+			if (!covered[i])
+			{
+				Location current = location;
+				Side side = (Side)i;
+				int sum = 0;
+
+				if (staticMoves[current.x][current.y].player != staticMoves[board.neighbours[current.x][current.y][side].x][board.neighbours[current.x][current.y][side].y].player)
+				{
+					do
+					{
+						if (board.inBounds[board.neighbours[current.x][current.y][(side + 1) % 6].x][board.neighbours[current.x][current.y][(side + 1) % 6].y]
+							&& staticMoves[current.x][current.y].player == staticMoves[board.neighbours[current.x][current.y][(side+1) % 6].x][board.neighbours[current.x][current.y][(side + 1) % 6].y].player)
+						{
+							sum += 1;
+							current = { board.neighbours[current.x][current.y][(side + 1) % 6].x, board.neighbours[current.x][current.y][(side + 1) % 6].y };
+							side = (Side)((side + 5) % 6);
+						}
+						else
+						{
+							sum -= 1;
+							side = (Side)((side + 1) % 6);
+						}
+						if (current == location)
+						{
+							covered[side] = true;
+						}
+
+					} while (!(current == location) || side != i);
+
+					if (sum == 6)
+					{
+						bool containsOther = flowFillSearch({ board.neighbours[location.x][location.y][i].x, board.neighbours[location.x][location.y][i].y }, getOtherPlayer(staticMoves[location.x][location.y].player));
+						if (containsOther)
+						{
+							return true;
+						}
+					}
+				}
+				covered[i] = true;
+			}
+		}
+
+		return false;
+	}
+	bool flowFillSearch(Location location, Player player) const
+	{
+		std::vector<Location> visited;
+		return flowFillSearchExpand(visited, location, player);
+	}
+	bool flowFillSearchExpand(std::vector<Location>& visited, Location location, Player player) const
+	{
+		Player current = staticMoves[location.x][location.y].player;
+		if (current == player)
+		{
+			return true;
+		}
+		else if (current == Player::Empty)
+		{
+			visited.push_back(location);
+			for (auto neighbour : board.neighbours[location.x][location.y])
+			{
+				if (board.inBounds[location.x][location.y])
+				{
+					if (std::find(visited.begin(), visited.end(), neighbour) == visited.end())
+					{
+						bool result = flowFillSearchExpand(visited, neighbour, player);
+						if (result)
+						{
+							return true;
+						}
+					}
+				}
+			}
+			return false;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	int evaluate() const
+	{
+		Instrument(Instrumentation::count(Evaluations));
+		Profile(Evaluate);
+		if (scores.size() > 0)
+		{
+			if (scores.back().hasCircleP1 || scores.back().straithP1 >= 5)
+			{
+				if (player == Player::P1)
+				{
+					return MaxScore;
+				}
+				else
+				{
+					return -MaxScore;
+				}
+			}
+			if (scores.back().hasCircleP2 || scores.back().straithP2 >= 5)
+			{
+				if (player == Player::P1)
+				{
+					return -MaxScore;
+				}
+				else
+				{
+					return MaxScore;
+				}
+			}
+
+			if (player == Player::P1)
+			{
+				return 10 * (scores.back().straithP1 - scores.back().straithP2) + scores.back().hasPossibleStraithP1 - scores.back().hasPossibleStraithP2;
+			}
+			else
+			{
+				return 10 * (scores.back().straithP2 - scores.back().straithP1) + scores.back().hasPossibleStraithP2 - scores.back().hasPossibleStraithP1;
+			}
+		}
+		else
+		{
+			return 0;
+		}
+	}
+	bool isEndGame() const
+	{
+		return scores.back().hasCircleP1 || scores.back().straithP1 >= 5
+			|| scores.back().hasCircleP2 || scores.back().straithP2 >= 5;
+	}
+
+	bool operator==(const State& other) const
+	{
+		bool staticMovesEqual = true;
+
+		for (int i = 0; i < XSIZE; i++)
+		{
+			for (int j = 0; j < YSIZE; j++)
+			{
+				if (!(staticMoves[i][j] == other.staticMoves[i][j]))
+				{
+					staticMovesEqual = false;
+				}
+			}
+		}
+
+		return player == other.player 
+			&& moveIndex == other.moveIndex 
+			&& moves == other.moves 
+			&& freeSpots == other.freeSpots 
+			&& staticMovesEqual;
+	}
+
+	Player player = Player::P1;
+	int moveIndex = 0;
+
+	std::vector<Move> moves;
+	std::vector<FreeSpot> freeSpots;
+
+	StaticLocation staticMoves[XSIZE][YSIZE];
+
+	Board board;
+
+	std::vector<Score> scores;
+
+	StateHash stateHash;
+};
+
+// Nodes with less depth left than this use the local table of their thread.
+#define SharedTableDepth 3
+#define LocalTableMB 2
+
+// Shared by all search threads without locks. An entry is two 64 bit words, the
+// packed result and the key XOR the packed result. A read that sees the halves of two
+// different writes fails the key check and counts as a miss, so a torn entry is never
+// used. Every entry is still checked by the caller: a key collision can hand out a
+// move that is not legal in the position.
+//
+// Entries live in buckets of four, one cache line. The buckets are allocated on huge
+// pages where possible, see LargePages.h, and cleared by as many threads as will
+// search the table. The allocation only reserves memory, so this first write also
+// decides on which NUMA node each page lives, see Numa.h for the policies. A store
+// overwrites the entry of the same position, else an empty one, else the one with the
+// least depth where entries of older searches count as shallower.
+class TranspositionTable
+{
+public:
+	explicit TranspositionTable(size_t sizeMB = 64, bool _largePages = true, int _threads = 1, NumaPolicy _numaPolicy = NumaPolicy::Off)
+		: largePages(_largePages), threads(_threads), numaPolicy(_numaPolicy)
+	{
+		resize(sizeMB);
+	}
+
+	~TranspositionTable()
+	{
+		freeLarge(buckets, allocated, backing);
+	}
+
+	TranspositionTable(const TranspositionTable&) = delete;
+	TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+	// Not while a search is using the table, the same holds for clear.
+	void resize(size_t sizeMB)
+	{
+		size_t amount = 1;
+		while (amount * 2 * sizeof(Bucket) <= (std::max)(sizeMB, (size_t)1) * 1024 * 1024)
+		{
+			amount *= 2;
+		}
+
+		freeLarge(buckets, allocated, backing);
+		allocated = amount * sizeof(Bucket);
+		buckets = (Bucket*)allocateLarge(allocated, largePages, backing);
+		if (!buckets)
+		{
+			throw std::bad_alloc();
+		}
+		if (numaPolicy == NumaPolicy::Interleave)
+		{
+			NumaTopology::get().interleave(buckets, allocated);
+		}
+
+		bucketMask = amount - 1;
+		clear();
+	}
+
+	// Every thread clears an equal slice, at least a megabyte each. With a NUMA policy
+	// slice i is cleared on the core of search thread i.
+	void clear()
+	{
+		auto start = std::chrono::steady_clock::now();
+		size_t amount = bucketMask + 1;
+		size_t workers = (std::max)((size_t)1, (std::min)((size_t)threads, amount * sizeof(Bucket) / (1024 * 1024)));
+
+		auto clearSlice = [this, amount, workers](size_t slice)
+		{
+			if (numaPolicy != NumaPolicy::Off)
+			{
+				NumaTopology::get().pinThread((int)slice);
+			}
+			for (size_t i = amount * slice / workers; i < amount * (slice + 1) / workers; i++)
+			{
+				new (&buckets[i]) Bucket();
+			}
+		};
+
+		// The calling thread only clears when it does not have to be pinned.
+		size_t first = numaPolicy == NumaPolicy::Off ? 1 : 0;
+		std::vector<std::thread> helpers;
+		for (size_t slice = first; slice < workers; slice++)
+		{
+			helpers.emplace_back(clearSlice, slice);
+		}
+		if (first == 1)
+		{
+			clearSlice(0);
+		}
+		for (auto& helper : helpers)
+		{
+			helper.join();
+		}
+
+		generation = 0;
+		clearTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		clearThreads = (int)workers;
+
+		std::lock_guard<std::mutex> lock(localMutex);
+		for (auto& table : localTables)
+		{
+			if (table)
+			{
+				table->clear();
+			}
+		}
+	}
+
+	// Small table of search thread index for the nodes close to the leaves, see SearchContext.
+	// It is made by the first call, on the calling thread so it lives on that thread's NUMA
+	// node, and kept for later searches with this table.
+	TranspositionTable& localTable(int thread)
+	{
+		std::lock_guard<std::mutex> lock(localMutex);
+		if ((int)localTables.size() <= thread)
+		{
+			localTables.resize(thread + 1);
+		}
+		if (!localTables[thread])
+		{
+			localTables[thread] = std::make_unique<TranspositionTable>(LocalTableMB, largePages);
+			localTables[thread]->generation = generation;
+		}
+		return *localTables[thread];
+	}
+
+	// Threads used by the next clear or resize, the search threads should touch their own part of the table.
+	void setThreads(int _threads)
+	{
+		threads = (std::max)(1, _threads);
+	}
+
+	// Seconds and threads of the last clear.
+	double lastClearTime() const
+	{
+		return clearTime;
+	}
+
+	int lastClearThreads() const
+	{
+		return clearThreads;
+	}
+
+	// Starts loading the bucket of key into the cache, so a probe soon after does not wait for memory.
+	// Building with NoTablePrefetch defined turns it off, to compare bench counters with and without.
+	void prefetch(unsigned long long key) const
+	{
+#if defined(NoTablePrefetch)
+		(void)key;
+#elif defined(_MSC_VER)
+		_mm_prefetch((const char*)&buckets[key & bucketMask], _MM_HINT_T0);
+#else
+		__builtin_prefetch(&buckets[key & bucketMask]);
+#endif
+	}
+
+	PageBacking pageBacking() const
+	{
+		return backing;
+	}
+
+	size_t sizeMB() const
+	{
+		return (bucketMask + 1) * sizeof(Bucket) / (1024 * 1024);
+	}
+
+	// Called at the start of every search, entries of earlier searches are replaced first.
+	void newSearch()
+	{
+		generation = (generation + 1) & 255;
+
+		std::lock_guard<std::mutex> lock(localMutex);
+		for (auto& table : localTables)
+		{
+			if (table)
+			{
+				table->newSearch();
+			}
+		}
+	}
+
+	// The move comes back as moveLocation, move is -1 since freeSpots indices are not stored.
+	bool probe(const StateHash& stateHash, StateTreeResult& result) const
+	{
+		Instrument(Instrumentation::count(TableProbes));
+		Profile(TableProbe);
+		const Bucket& bucket = buckets[stateHash.key & bucketMask];
+		for (const auto& entry : bucket.entries)
+		{
+			unsigned long long data = entry.data.load(std::memory_order_relaxed);
+			if ((entry.key.load(std::memory_order_relaxed) ^ data) == stateHash.key && data != 0)
+			{
+				unpack(data, result);
+				if (result.moveLocation.x >= 0)
+				{
+					result.moveLocation = boardSymmetries.apply(boardSymmetries.inverse(stateHash.symmetry), result.moveLocation);
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	enum StoreResult
+	{
+		Inserted, Replaced, Rejected
+	};
+
+	// The move is stored as the move of the image of stateHash.key, probe maps it back.
+	StoreResult store(const StateHash& stateHash, StateTreeResult result)
+	{
+		Instrument(Instrumentation::count(TableStores));
+		Profile(TableStore);
+		Bucket& bucket = buckets[stateHash.key & bucketMask];
+		if (result.move >= 0)
+		{
+			result.moveLocation = boardSymmetries.apply(stateHash.symmetry, result.moveLocation);
+		}
+
+		Entry* target = nullptr;
+		int targetWorth = 0;
+		for (auto& entry : bucket.entries)
+		{
+			unsigned long long data = entry.data.load(std::memory_order_relaxed);
+			if (data != 0 && (entry.key.load(std::memory_order_relaxed) ^ data) == stateHash.key)
+			{
+				// Keep a deeper result of the same search unless the new one is exact.
+				if (result.type != ValueType::Exact && result.depth + 2 < depthOf(data) && generationOf(data) == generation)
+				{
+					return Rejected;
+				}
+				write(entry, stateHash.key, result);
+				return Replaced;
+			}
+
+			// Empty entries are worth least, then entries of earlier searches.
+			int worth = data == 0 ? -512 : depthOf(data) - (generationOf(data) == generation ? 0 : 256);
+			if (!target || worth < targetWorth)
+			{
+				target = &entry;
+				targetWorth = worth;
+			}
+		}
+
+		write(*target, stateHash.key, result);
+		return targetWorth == -512 ? Inserted : Replaced;
+	}
+
+	// Filled entries, counted over the whole table.
+	size_t size() const
+	{
+		size_t filled = 0;
+		for (size_t i = 0; i <= bucketMask; i++)
+		{
+			for (const auto& entry : buckets[i].entries)
+			{
+				filled += entry.data.load(std::memory_order_relaxed) != 0;
+			}
+		}
+		return filled;
+	}
+
+private:
+	struct Entry
+	{
+		std::atomic<unsigned long long> key{ 0 };
+		std::atomic<unsigned long long> data{ 0 };
+	};
+
+	struct alignas(64) Bucket
+	{
+		Entry entries[4];
+	};
+
+	// Bits 0-15 value + 32768, 16-23 depth, 24-25 type, 26-34 move as x * YSIZE + y
+	// (511 for none), 35-42 generation, 63 always set so a filled entry is never 0.
+	unsigned long long pack(const StateTreeResult& result) const
+	{
+		unsigned long long move = result.move >= 0 ? result.moveLocation.x * YSIZE + result.moveLocation.y : 511;
+		return (unsigned long long)(result.value + 32768)
+			| (unsigned long long)(std::min)((std::max)(result.depth, 0), 255) << 16
+			| (unsigned long long)result.type << 24
+			| move << 26
+			| (unsigned long long)generation << 35
+			| 1ull << 63;
+	}
+
+	static void unpack(unsigned long long data, StateTreeResult& result)
+	{
+		result = StateTreeResult((int)(data & 0xffff) - 32768);
+		result.depth = depthOf(data);
+		result.type = (ValueType)(data >> 24 & 3);
+
+		int move = (int)(data >> 26 & 511);
+		result.moveLocation = move < 511 ? Location{ move / YSIZE, move % YSIZE } : Location{ -1, -1 };
+	}
+
+	void write(Entry& entry, unsigned long long key, const StateTreeResult& result)
+	{
+		unsigned long long data = pack(result);
+		entry.key.store(key ^ data, std::memory_order_relaxed);
+		entry.data.store(data, std::memory_order_relaxed);
+	}
+
+	static int depthOf(unsigned long long data)
+	{
+		return (int)(data >> 16 & 255);
+	}
+
+	static int generationOf(unsigned long long data)
+	{
+		return (int)(data >> 35 & 255);
+	}
+
+	Bucket* buckets = nullptr;
+	size_t bucketMask = 0;
+	int generation = 0;
+
+	bool largePages;
+	int threads;
+	NumaPolicy numaPolicy;
+	double clearTime = 0;
+	int clearThreads = 1;
+	size_t allocated = 0;
+	PageBacking backing = PageBacking::Default;
+
+	std::mutex localMutex;
+	std::vector<std::unique_ptr<TranspositionTable>> localTables;
+};
+
+// Evaluations by position, shared by all threads and searches since the evaluation only
+// depends on the position. Direct mapped, every entry is one word holding the upper 48
+// bits of the key and the value, so a read never sees half of another write.
+#define EvalCacheEntries (1 << 17)
+
+class EvalCache
+{
+public:
+	static EvalCache& get()
+	{
+		static EvalCache cache;
+		return cache;
+	}
+
+	bool probe(unsigned long long key, int& value) const
+	{
+		unsigned long long entry = entries[key & (EvalCacheEntries - 1)].load(std::memory_order_relaxed);
+		if (entry != 0 && (entry & ~0xffffull) == (key & ~0xffffull))
+		{
+			value = (int)(entry & 0xffff) - 32768;
+			return true;
+		}
+		return false;
+	}
+
+	void store(unsigned long long key, int value)
+	{
+		entries[key & (EvalCacheEntries - 1)].store((key & ~0xffffull) | (unsigned long long)(value + 32768), std::memory_order_relaxed);
+	}
+
+	void clear()
+	{
+		for (auto& entry : entries)
+		{
+			entry.store(0, std::memory_order_relaxed);
+		}
+	}
+
+private:
+	EvalCache()
+	{
+		clear();
+	}
+
+	std::atomic<unsigned long long> entries[EvalCacheEntries];
+};
+
+#define SharedNodeBatch 64 // power of two
+
+// Everything one search thread needs besides the state. Nodes close to the leaves are
+// many and only worth something to the thread that searches that subtree, they go to
+// the local table of the thread, see TranspositionTable::localTable. Deeper nodes share
+// the big table. thread is the index of the search thread, helpers of one search need
+// different indices.
+struct SearchContext
+{
+	SearchContext(TranspositionTable& _transpositionTable, std::atomic<bool>& _stop, int _thread = 0)
+		: transpositionTable(_transpositionTable), stop(_stop), thread(_thread), pvTable(MaxPly * MaxPly)
+	{
+		pvLength.fill(0);
+	}
+
+	// Raises stop once the node or time limit is reached. With sharedNodes the node limit
+	// is on the total of all threads of the search: every SharedNodeBatch nodes a thread
+	// adds its nodes to the total and learns how many the others have searched.
+	void countNode()
+	{
+		counters.nodes++;
+		if (sharedNodes && (counters.nodes & (SharedNodeBatch - 1)) == 0)
+		{
+			otherNodes = sharedNodes->fetch_add(SharedNodeBatch, std::memory_order_relaxed) + SharedNodeBatch - counters.nodes;
+		}
+		if (otherNodes + counters.nodes >= maxNodes || ((counters.nodes & 1023) == 0 && std::chrono::steady_clock::now() >= deadline.load(std::memory_order_relaxed)))
+		{
+			stop = true;
+		}
+	}
+
+	// State::evaluate through the evaluation cache.
+	int evaluate(const State& state)
+	{
+		counters.evalProbes++;
+		int value;
+		if (EvalCache::get().probe(state.stateHash.key, value))
+		{
+			counters.evalHits++;
+			return value;
+		}
+		value = state.evaluate();
+		EvalCache::get().store(state.stateHash.key, value);
+		return value;
+	}
+
+	// The local table is only taken at the first shallow node, on the thread that searches.
+	TranspositionTable& tableFor(int depth)
+	{
+		if (depth >= SharedTableDepth)
+		{
+			return transpositionTable;
+		}
+		if (!localTable)
+		{
+			localTable = &transpositionTable.localTable(thread);
+		}
+		return *localTable;
+	}
+
+	TranspositionTable& transpositionTable;
+	TranspositionTable* localTable = nullptr;
+	std::atomic<bool>& stop;
+	int thread;
+
+	bool isExcluded(Location location) const
+	{
+		return std::find(excludedMoves.begin(), excludedMoves.end(), location) != excludedMoves.end();
+	}
+
+	// The best line found from ply onwards is the best move followed by the child's line.
+	void updatePV(int ply, Location move)
+	{
+		pvTable[ply * MaxPly + ply] = move;
+		for (int i = ply + 1; i < pvLength[ply + 1]; i++)
+		{
+			pvTable[ply * MaxPly + i] = pvTable[(ply + 1) * MaxPly + i];
+		}
+		pvLength[ply] = pvLength[ply + 1];
+	}
+
+	// Principal variation of the last search, may be cut short by a table hit on the way.
+	std::vector<Location> principalVariation() const
+	{
+		return std::vector<Location>(pvTable.begin(), pvTable.begin() + pvLength[0]);
+	}
+
+	SearchCounters counters;
+
+	long long maxNodes = std::numeric_limits<long long>::max();
+	std::atomic<long long>* sharedNodes = nullptr;
+	long long otherNodes = 0; // nodes of the other threads at the last batch
+	// Atomic so a ponder hit can set it while the search runs.
+	std::atomic<std::chrono::steady_clock::time_point> deadline{ std::chrono::steady_clock::time_point::max() };
+
+	// Triangular table, row ply holds the line from ply in the columns ply to pvLength[ply] - 1.
+	std::vector<Location> pvTable;
+	std::array<int, MaxPly> pvLength;
+	// The previous principal variation is searched first for as long as the search is on it.
+	std::vector<Location> previousPV;
+	bool followPV = false;
+
+	// Root moves skipped by multiPV.
+	std::vector<Location> excludedMoves;
+	// Lines of the previous multiPV call, line n tries the first move of line n first.
+	std::vector<std::vector<Location>> linePVs;
+};
+
+// Parses a move list of "x,y" cells separated by whitespace.
+inline std::vector<Location> parseMoves(const std::string& text)
+{
+	std::vector<Location> moves;
+	std::istringstream stream(text);
+	std::string token;
+
+	while (stream >> token)
+	{
+		Location location;
+		char comma;
+		std::istringstream cell(token);
+		if (!(cell >> location.x >> comma >> location.y) || comma != ',' || !cell.eof())
+		{
+			throw std::invalid_argument("Invalid move: " + token);
+		}
+		moves.push_back(location);
+	}
+
+	return moves;
+}
+
+// Plays the moves on a fresh state, the first move has to be the centre (10, 10).
+inline void playMoves(State& state, const std::vector<Location>& moves)
+{
+	for (const auto& location : moves)
+	{
+		bool legal = false;
+		if (0 <= location.x && location.x < XSIZE && 0 <= location.y && location.y < YSIZE)
+		{
+			if (state.moves.empty())
+			{
+				legal = location.x == 10 && location.y == 10;
+			}
+			else
+			{
+				legal = !state.isEndGame() && state.isFreeSpot(location.x, location.y);
+			}
+		}
+
+		if (!legal)
+		{
+			throw std::invalid_argument("Illegal move: " + std::to_string(location.x) + "," + std::to_string(location.y));
+		}
+
+		state.makeMove(location.x, location.y);
+	}
+}
+
+// Root moves that need no search when the position is symmetric: a move and its image
+// under a symmetry of the position lead to images of the same positions. The images of
+// excluded moves are skipped with them, so multiPV excludes whole classes. Of every
+// other class one move is kept, the one at freeSpots index first if it is in the class,
+// else the lowest index.
+inline std::vector<Location> symmetricRootMoves(const State& state, int first, const std::vector<Location>& excluded)
+{
+	std::vector<Location> skipped;
+	std::vector<int> symmetries = state.symmetries();
+	if (symmetries.empty())
+	{
+		return skipped;
+	}
+
+	std::vector<Location> order = excluded;
+	if (first >= 0)
+	{
+		order.push_back(state.freeSpots[first].location);
+	}
+	for (const auto& spot : state.freeSpots)
+	{
+		if (spot.moveIndex > 0)
+		{
+			order.push_back(spot.location);
+		}
+	}
+
+	for (const auto& location : order)
+	{
+		if (std::find(skipped.begin(), skipped.end(), location) != skipped.end())
+		{
+			continue;
+		}
+		for (int symmetry : symmetries)
+		{
+			Location image = boardSymmetries.apply(symmetry, location);
+			if (!(image == location) && std::find(skipped.begin(), skipped.end(), image) == skipped.end())
+			{
+				skipped.push_back(image);
+			}
+		}
+	}
+	return skipped;
+}
+
+inline StateTreeResult alphaBeta(State& state, SearchContext& context, int depth, int alpha, int beta, int ply = 0)
+{
+	Profile(AlphaBeta);
+	long nodesVisited = 0;
+	context.countNode();
+	Instrument(Instrumentation::sample(NodeDepth, depth));
+
+	// With excluded moves the root entry describes a different set of moves, neither use nor store it.
+	bool excluding = ply == 0 && !context.excludedMoves.empty();
+	if (ply == 0)
+	{
+		context.previousPV = context.principalVariation();
+		context.followPV = !excluding;
+	}
+	context.pvLength[ply] = ply;
+
+	if (depth <= 0 || ply >= MaxPly - 1 || state.isEndGame())
+	{
+		int value = context.evaluate(state);
+		return StateTreeResult(value == MaxScore ? MaxScore - ply : value == -MaxScore ? -MaxScore + ply : value);
+	}
+
+	// No line from here ends sooner than the game being lost now or won with the next move.
+	int lowest = -MaxScore + ply;
+	int highest = MaxScore - ply - 1;
+	if (lowest >= beta)
+	{
+		return StateTreeResult(lowest);
+	}
+	if (highest <= alpha)
+	{
+		return StateTreeResult(highest);
+	}
+
+	int olda = alpha;
+	int bestMove = -1;
+	bool cacheFound = false;
+	StateTreeResult result(0);
+	context.counters.ttProbes++;
+	TranspositionTable& table = context.tableFor(depth);
+	if (!excluding && table.probe(state.stateHash, result))
+	{
+		for (int i = 0; i < state.freeSpots.size(); i++)
+		{
+			if (state.freeSpots[i].moveIndex > 0 && state.freeSpots[i].location == result.moveLocation)
+			{
+				bestMove = i;
+			}
+		}
+		// A move that is not legal here means the key collided with another position.
+		cacheFound = bestMove != -1 || result.moveLocation.x < 0;
+		result.move = bestMove;
+	}
+
+	if (cacheFound)
+	{
+		context.counters.ttHits++;
+		nodesVisited += result.nodesVisited;
+		result.value = scoreFromTable(result.value, ply);
+		if (result.depth >= depth && (ply > 0 || bestMove != -1))
+		{
+			if (result.type == ValueType::Exact)
+			{
+				return result;
+			}
+			else if (result.type == ValueType::Lower)
+			{
+				alpha = (std::max)(alpha, result.value);
+			}
+			else if (result.type == ValueType::Upper)
+			{
+				beta = (std::min)(beta, result.value);
+			}
+			if (alpha >= beta)
+			{
+				return result;
+			}
+		}
+	}
+	else if (excluding && context.excludedMoves.size() < context.linePVs.size())
+	{
+		Location hint = context.linePVs[context.excludedMoves.size()][0];
+		for (int i = 0; i < state.freeSpots.size(); i++)
+		{
+			if (state.freeSpots[i].moveIndex > 0 && state.freeSpots[i].location == hint && !context.isExcluded(hint))
+			{
+				bestMove = i;
+			}
+		}
+	}
+
+	if (context.followPV)
+	{
+		context.followPV = false;
+		for (int i = 0; ply < context.previousPV.size() && i < state.freeSpots.size(); i++)
+		{
+			if (state.freeSpots[i].moveIndex > 0 && state.freeSpots[i].location == context.previousPV[ply] && (bestMove == -1 || bestMove == i))
+			{
+				bestMove = i;
+				context.followPV = true;
+			}
+		}
+	}
+
+	std::vector<Location> symmetricMoves;
+	if (ply == 0)
+	{
+		symmetricMoves = symmetricRootMoves(state, bestMove, context.excludedMoves);
+		// The hint of a multiPV line may be an image of a move of an earlier line.
+		if (bestMove != -1 && std::find(symmetricMoves.begin(), symmetricMoves.end(), state.freeSpots[bestMove].location) != symmetricMoves.end())
+		{
+			bestMove = -1;
+			context.followPV = false;
+		}
+	}
+
+	bool localStop = false;
+	int score = -999;
+	int index = -1;
+	int searched = 0;
+	if (bestMove != -1)
+	{
+		if (depth > 1)
+		{
+			context.tableFor(depth - 1).prefetch(state.keyAfter(state.freeSpots[bestMove].location.x, state.freeSpots[bestMove].location.y));
+		}
+		state.makeMove(state.freeSpots[bestMove].location.x, state.freeSpots[bestMove].location.y);
+		auto result = alphaBeta(state, context, depth - 1, -beta, -alpha, ply + 1);
+		state.undoMove();
+		context.followPV = false;
+
+		result.value = -result.value;
+		nodesVisited += result.nodesVisited;
+		searched++;
+
+		if (result.value > score)
+		{
+			score = result.value;
+			index = bestMove;
+		}
+		if (score > alpha)
+		{
+			alpha = score;
+			context.updatePV(ply, state.freeSpots[bestMove].location);
+		}
+		if (score >= beta) localStop = true;
+	}
+
+	if(!localStop)
+	{
+		for (int i = 0; i < state.freeSpots.size() && !context.stop; i++)
+		{
+			if (state.freeSpots[i].moveIndex > 0 && i != bestMove && !(excluding && context.isExcluded(state.freeSpots[i].location))
+				&& std::find(symmetricMoves.begin(), symmetricMoves.end(), state.freeSpots[i].location) == symmetricMoves.end())
+			{
+				// Only children that probe the table, the leaves do not.
+				if (depth > 1)
+				{
+					context.tableFor(depth - 1).prefetch(state.keyAfter(state.freeSpots[i].location.x, state.freeSpots[i].location.y));
+				}
+				state.makeMove(state.freeSpots[i].location.x, state.freeSpots[i].location.y);
+				auto result = alphaBeta(state, context, depth - 1, -beta, -alpha, ply + 1);
+				state.undoMove();
+
+				result.value = -result.value;
+				nodesVisited += result.nodesVisited;
+				searched++;
+
+				if (result.value > score)
+				{
+					score = result.value;
+					index = i;
+				}
+				if (score > alpha)
+				{
+					alpha = score;
+					context.updatePV(ply, state.freeSpots[i].location);
+				}
+				if (score >= beta) break;
+			}
+		}
+	}
+
+	Instrument(Instrumentation::sample(MovesSearched, searched));
+	if (score >= beta && !context.stop)
+	{
+		Instrument(Instrumentation::sample(CutoffIndex, searched - 1));
+		context.counters.cutoffs++;
+		if (searched == 1)
+		{
+			context.counters.firstMoveCutoffs++;
+		}
+	}
+
+	// A stopped search may not have looked at every move.
+	if (!context.stop && !excluding)
+	{
+		StateTreeResult result(scoreToTable(score, ply), nodesVisited, index);
+		result.move = index;
+		result.moveLocation = state.freeSpots[index].location;
+		result.depth = depth;
+
+		if (score <= olda)
+		{
+			result.type = ValueType::Upper;
+		}
+		else if (score >= beta)
+		{
+			result.type = ValueType::Lower;
+		}
+		else
+		{
+			result.type = ValueType::Exact;
+		}
+
+		auto stored = table.store(state.stateHash, result);
+		if (stored != TranspositionTable::Rejected) context.counters.ttStores++;
+		if (stored == TranspositionTable::Replaced) context.counters.ttReplaces++;
+	}
+
+	return StateTreeResult(score, nodesVisited, index);
+}
+
+// The best root moves with exact scores, best first, their lines end up in
+// context.linePVs. Every line searches the root without the moves of the lines
+// before it. A line can not score above the one before it, so that score bounds
+// the window; the lines share the table, so the later ones mostly reuse the
+// subtrees and move ordering of the first. In a symmetric position a line stands
+// for all its images, see symmetricRootMoves, so there may be fewer lines than asked.
+inline std::vector<StateTreeResult> multiPV(State& state, SearchContext& context, int depth, int lines)
+{
+	std::vector<StateTreeResult> results;
+	std::vector<std::vector<Location>> pvs;
+	context.excludedMoves.clear();
+	if (!context.linePVs.empty())
+	{
+		context.pvLength[0] = (int)context.linePVs[0].size();
+		std::copy(context.linePVs[0].begin(), context.linePVs[0].end(), context.pvTable.begin());
+	}
+
+	while ((int)results.size() < lines && !context.stop)
+	{
+		int beta = results.empty() ? 999 : results.back().value + 1;
+		StateTreeResult result = alphaBeta(state, context, depth, -999, beta);
+		if (context.stop || result.move < 0)
+		{
+			break;
+		}
+
+		result.moveLocation = state.freeSpots[result.move].location;
+		result.depth = depth;
+		results.push_back(result);
+		context.excludedMoves.push_back(result.moveLocation);
+
+		auto pv = context.principalVariation();
+		if (pv.empty() || !(pv[0] == result.moveLocation))
+		{
+			pv = { result.moveLocation };
+		}
+		pvs.push_back(pv);
+	}
+
+	context.excludedMoves.clear();
+	if (!pvs.empty())
+	{
+		context.linePVs = pvs;
+	}
+	return results;
+}
+
+// The line the transposition table predicts after the first move, stops at the first missing or stale entry.
+inline std::vector<Location> principalVariation(State& state, const TranspositionTable& transpositionTable, Location first, int maxLength)
+{
+	std::vector<Location> pv;
+	if (!state.isFreeSpot(first.x, first.y))
+	{
+		return pv;
+	}
+
+	pv.push_back(first);
+	state.makeMove(first.x, first.y);
+
+	StateTreeResult entry(0);
+	while ((int)pv.size() < maxLength && !state.isEndGame() && transpositionTable.probe(state.stateHash, entry)
+		&& entry.moveLocation.x >= 0 && state.isFreeSpot(entry.moveLocation.x, entry.moveLocation.y))
+	{
+		pv.push_back(entry.moveLocation);
+		state.makeMove(entry.moveLocation.x, entry.moveLocation.y);
+	}
+
+	for (size_t i = 0; i < pv.size(); i++)
+	{
+		state.undoMove();
+	}
+
+	return pv;
+}
\ No newline at end of file
@@ -0,0 +1,373 @@
+#pragma once
+
+#include "Search.h"
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <functional>
+#include <condition_variable>
+
+#define MaxSearchDepth 64
+
+struct SearchLimits
+{
+	int maxTime = -1; // ms, -1 for no limit
+	int maxDepth = MaxSearchDepth;
+	long long maxNodes = -1; // -1 for no limit
+	int multiPV = 1; // root moves reported with an exact score
+	bool ponder = false; // no time limit and no result until ponderHit
+	bool infinite = false; // no result until forceStop, even after the last iteration
+	bool pinThreads = false; // thread i on a core of NUMA node i % nodes, see Numa.h
+};
+
+// Reported after every completed iteration.
+struct SearchInfo
+{
+	int depth;
+	int multiPV; // line number, 1 is the best move
+	int score;
+	long long nodes;
+	long long nps;
+	int time;
+	std::vector<Location> pv;
+};
+
+// Iterative deepening on a private copy of the state. With more than one thread
+// the helpers search the same position (lazy SMP) and only share the table. Every
+// thread builds its own state, board tables included, after it has been pinned, so
+// they live on its own NUMA node.
+//
+// A ponder search is started on the position after the expected reply, while the
+// opponent thinks. If the opponent plays that reply, ponderHit turns it into the
+// real search: the time limit starts counting and the iterations done so far are
+// kept. Otherwise it is destroyed like any other search, what it stored in the
+// table stays useful for the next search.
+class SearchControl
+{
+public:
+	SearchControl(const State& state, TranspositionTable& _transpositionTable, SearchLimits _limits, int threads = 1,
+		std::function<void(const SearchInfo&)> _onInfo = nullptr, std::function<void(const StateTreeResult&, const SearchStats&)> _onFinished = nullptr)
+		: transpositionTable(_transpositionTable), context(_transpositionTable, stop), result(-9999, 0, -1)
+	{
+		limits = _limits;
+		onInfo = _onInfo;
+		onFinished = _onFinished;
+		start = std::chrono::steady_clock::now();
+		pondering = limits.ponder;
+		transpositionTable.newSearch();
+
+		if (limits.maxTime >= 0 && !pondering)
+		{
+			context.deadline = start + std::chrono::milliseconds(limits.maxTime);
+		}
+		if (limits.maxNodes >= 0)
+		{
+			context.maxNodes = limits.maxNodes;
+			if (threads > 1)
+			{
+				context.sharedNodes = &sharedNodes;
+			}
+		}
+
+		for (const auto& move : state.moves)
+		{
+			rootMoves.push_back(move.location);
+		}
+		states.resize(threads > 0 ? threads : 1);
+		threadNodes.resize(states.size());
+
+		for (int i = 0; i < state.freeSpots.size(); i++)
+		{
+			if (state.freeSpots[i].moveIndex > 0)
+			{
+				result.move = i;
+				result.moveLocation = state.freeSpots[i].location;
+				break;
+			}
+		}
+
+		worker = std::make_unique<std::thread>(&SearchControl::workerFunction, this);
+	}
+	~SearchControl()
+	{
+		forceStop();
+		worker->join();
+	}
+
+	void tick()
+	{
+		if (std::chrono::steady_clock::now() > context.deadline.load())
+		{
+			forceStop();
+		}
+	}
+
+	void forceStop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(resultMutex);
+			stop = true;
+			pondering = false;
+		}
+		ponderCondition.notify_all();
+	}
+
+	// The opponent played the expected reply, from now on this is a normal search.
+	void ponderHit()
+	{
+		{
+			std::lock_guard<std::mutex> lock(resultMutex);
+			if (limits.maxTime >= 0)
+			{
+				context.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(limits.maxTime);
+			}
+			pondering = false;
+		}
+		ponderCondition.notify_all();
+	}
+
+	bool isPondering()
+	{
+		return pondering;
+	}
+
+	bool isFinished()
+	{
+		return finished;
+	}
+
+	StateTreeResult getResult()
+	{
+		std::lock_guard<std::mutex> lock(resultMutex);
+		return result;
+	}
+
+	// Blocks until the search has finished, without polling.
+	StateTreeResult waitForResult()
+	{
+		std::unique_lock<std::mutex> lock(resultMutex);
+		finishedCondition.wait(lock, [this]() { return finished.load(); });
+		return result;
+	}
+
+	int getTotalTime()
+	{
+		return totalTime;
+	}
+
+	int getLevelReached()
+	{
+		return levelReached;
+	}
+
+	// Principal variation of the last completed iteration, the best move first.
+	std::vector<Location> getPV()
+	{
+		std::lock_guard<std::mutex> lock(resultMutex);
+		return pv;
+	}
+
+	// Lines of the last completed iteration, best first. Only the best line without multiPV.
+	std::vector<StateTreeResult> getLines()
+	{
+		std::lock_guard<std::mutex> lock(resultMutex);
+		return lines;
+	}
+
+	// Updated after every completed iteration, safe to call while searching.
+	SearchStats getStats()
+	{
+		std::lock_guard<std::mutex> lock(resultMutex);
+		return stats;
+	}
+
+
+private:
+	void prepareThread(int index)
+	{
+		if (limits.pinThreads)
+		{
+			NumaTopology::get().pinThread(index);
+		}
+
+		states[index] = std::make_unique<State>();
+		for (const auto& move : rootMoves)
+		{
+			states[index]->makeMove(move.x, move.y);
+		}
+	}
+
+	void workerFunction()
+	{
+		std::vector<std::thread> helpers;
+		for (int i = 1; i < states.size(); i++)
+		{
+			helpers.emplace_back(&SearchControl::helperFunction, this, i);
+		}
+
+		prepareThread(0);
+		State& state = *states[0];
+
+		for (int i = 1; i <= limits.maxDepth; i++)
+		{
+			std::vector<StateTreeResult> newLines;
+			std::vector<std::vector<Location>> pvs;
+			if (limits.multiPV > 1)
+			{
+				newLines = multiPV(state, context, i, limits.multiPV);
+				pvs = context.linePVs;
+			}
+			else
+			{
+				StateTreeResult line = alphaBeta(state, context, i, -999, 999);
+				if (stop || line.move < 0)
+				{
+					break;
+				}
+				line.moveLocation = state.freeSpots[line.move].location;
+				line.depth = i;
+				newLines.push_back(line);
+				pvs.push_back(context.principalVariation());
+			}
+
+			if (stop || newLines.empty())
+			{
+				break;
+			}
+			StateTreeResult newResult = newLines[0];
+
+			for (int j = 0; j < newLines.size(); j++)
+			{
+				if (pvs[j].empty() || !(pvs[j][0] == newLines[j].moveLocation))
+				{
+					// The root score came straight from the table.
+					pvs[j] = principalVariation(state, transpositionTable, newLines[j].moveLocation, i);
+				}
+			}
+
+			auto now = std::chrono::steady_clock::now();
+			double seconds = std::chrono::duration<double>(now - start).count();
+			SearchCounters counters = context.counters;
+			{
+				std::lock_guard<std::mutex> lock(helperMutex);
+				counters += helperCounters;
+			}
+			long long nodes = counters.nodes;
+
+			{
+				std::lock_guard<std::mutex> lock(resultMutex);
+				result = newResult;
+				lines = newLines;
+				pv = pvs[0];
+				levelReached = i;
+				stats.addIteration(i, newResult.value, counters, seconds);
+			}
+
+			for (int j = 0; j < newLines.size() && onInfo; j++)
+			{
+				SearchInfo info;
+				info.depth = i;
+				info.multiPV = j + 1;
+				info.score = newLines[j].value;
+				info.nodes = nodes;
+				info.nps = (long long)(nodes / (seconds > 0 ? seconds : 1));
+				info.time = (int)std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+				info.pv = pvs[j];
+				onInfo(info);
+			}
+
+			// Without extensions every line up to this depth has been searched, a shorter win or longer loss does not exist.
+			if (isDecided(newResult.value))
+			{
+				break;
+			}
+		}
+
+		// A ponder search that ran out of depth waits for the hit before it reports, an
+		// infinite search waits to be stopped.
+		{
+			std::unique_lock<std::mutex> lock(resultMutex);
+			ponderCondition.wait(lock, [this]() { return !pondering.load() && (!limits.infinite || stop.load()); });
+		}
+
+		stop = true;
+		for (auto& helper : helpers)
+		{
+			helper.join();
+		}
+		threadNodes[0] = context.counters.nodes;
+
+		auto end = std::chrono::steady_clock::now();
+		totalTime = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+		{
+			std::lock_guard<std::mutex> lock(resultMutex);
+			const auto& topology = NumaTopology::get();
+			stats.numaNodeNps.assign(topology.nodeCount(), 0);
+			for (int i = 0; i < threadNodes.size(); i++)
+			{
+				stats.numaNodeNps[topology.nodeOfThread(i)] += threadNodes[i] * 1000 / (totalTime > 0 ? totalTime : 1);
+			}
+			finished = true;
+		}
+		finishedCondition.notify_all();
+
+		if (onFinished)
+		{
+			onFinished(getResult(), getStats());
+		}
+	}
+
+	void helperFunction(int index)
+	{
+		prepareThread(index);
+		SearchContext context(transpositionTable, stop, index);
+		context.maxNodes = this->context.maxNodes;
+		context.sharedNodes = this->context.sharedNodes;
+
+		// Odd helpers run one ply ahead so the threads spread over different depths.
+		for (int i = 1 + index % 2; i <= limits.maxDepth && !stop; i++)
+		{
+			SearchCounters before = context.counters;
+			alphaBeta(*states[index], context, i, -999, 999);
+
+			std::lock_guard<std::mutex> lock(helperMutex);
+			helperCounters += context.counters - before;
+			threadNodes[index] = context.counters.nodes;
+		}
+	}
+
+private:
+	std::atomic<bool> stop{ false };
+	std::atomic<bool> finished{ false };
+	SearchLimits limits;
+
+	std::chrono::steady_clock::time_point start;
+
+	std::atomic<bool> pondering{ false };
+	std::condition_variable ponderCondition;
+
+	std::vector<Location> rootMoves;
+	std::vector<std::unique_ptr<State>> states;
+	std::unique_ptr<std::thread> worker;
+	TranspositionTable& transpositionTable;
+	SearchContext context;
+
+	std::function<void(const SearchInfo&)> onInfo;
+	std::function<void(const StateTreeResult&, const SearchStats&)> onFinished;
+
+	std::mutex resultMutex;
+	std::condition_variable finishedCondition;
+	StateTreeResult result;
+	std::vector<StateTreeResult> lines;
+	std::vector<Location> pv;
+	SearchStats stats;
+
+	std::atomic<long long> sharedNodes{ 0 }; // nodes of all threads under a node limit, see SearchContext::countNode
+
+	std::mutex helperMutex;
+	SearchCounters helperCounters;
+	std::vector<long long> threadNodes;
+	int totalTime = 0;
+	int levelReached = 0;
+};
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+
+// Raw counters of one search thread, see SearchContext.
+struct SearchCounters
+{
+	long long nodes = 0;
+	long long ttProbes = 0;
+	long long ttHits = 0;
+	long long ttStores = 0;
+	long long ttReplaces = 0;
+	long long evalProbes = 0;
+	long long evalHits = 0;
+	long long cutoffs = 0;
+	long long firstMoveCutoffs = 0;
+
+	SearchCounters& operator+=(const SearchCounters& other)
+	{
+		nodes += other.nodes;
+		ttProbes += other.ttProbes;
+		ttHits += other.ttHits;
+		ttStores += other.ttStores;
+		ttReplaces += other.ttReplaces;
+		evalProbes += other.evalProbes;
+		evalHits += other.evalHits;
+		cutoffs += other.cutoffs;
+		firstMoveCutoffs += other.firstMoveCutoffs;
+		return *this;
+	}
+
+	SearchCounters& operator-=(const SearchCounters& other)
+	{
+		nodes -= other.nodes;
+		ttProbes -= other.ttProbes;
+		ttHits -= other.ttHits;
+		ttStores -= other.ttStores;
+		ttReplaces -= other.ttReplaces;
+		evalProbes -= other.evalProbes;
+		evalHits -= other.evalHits;
+		cutoffs -= other.cutoffs;
+		firstMoveCutoffs -= other.firstMoveCutoffs;
+		return *this;
+	}
+
+	double ttHitRate() const
+	{
+		return ttProbes > 0 ? (double)ttHits / ttProbes : 0;
+	}
+
+	double evalHitRate() const
+	{
+		return evalProbes > 0 ? (double)evalHits / evalProbes : 0;
+	}
+
+	// Share of beta cutoffs produced by the first move searched, a measure of move ordering.
+	double firstMoveCutoffRate() const
+	{
+		return cutoffs > 0 ? (double)firstMoveCutoffs / cutoffs : 0;
+	}
+};
+
+inline SearchCounters operator-(SearchCounters left, const SearchCounters& right)
+{
+	return left -= right;
+}
+
+// Counters of one iteration of iterative deepening, not cumulative.
+struct IterationStats
+{
+	int depth = 0;
+	int score = 0;
+	double time = 0; // seconds spent in this iteration
+	long long nps = 0;
+	double branchingFactor = 0; // nodes of this iteration over nodes of the previous one
+	SearchCounters counters;
+};
+
+// Statistics of one search, filled by SearchControl after every completed iteration.
+class SearchStats
+{
+public:
+	// total are the counters of all threads since the start, seconds the time since the start.
+	void addIteration(int depth, int score, const SearchCounters& total, double seconds)
+	{
+		IterationStats iteration;
+		iteration.depth = depth;
+		iteration.score = score;
+		iteration.time = seconds - time;
+		iteration.counters = total - counters;
+		iteration.nps = (long long)(iteration.counters.nodes / (iteration.time > 0 ? iteration.time : 1));
+		if (!iterations.empty() && iterations.back().counters.nodes > 0)
+		{
+			iteration.branchingFactor = (double)iteration.counters.nodes / iterations.back().counters.nodes;
+		}
+
+		iterations.push_back(iteration);
+		counters = total;
+		time = seconds;
+	}
+
+	// Effective branching factor over the whole search.
+	double branchingFactor() const
+	{
+		if (iterations.size() < 2 || iterations.front().counters.nodes <= 0)
+		{
+			return 0;
+		}
+		return std::pow((double)iterations.back().counters.nodes / iterations.front().counters.nodes, 1.0 / (iterations.size() - 1));
+	}
+
+	long long nps() const
+	{
+		return (long long)(counters.nodes / (time > 0 ? time : 1));
+	}
+
+	std::string toJson() const
+	{
+		std::ostringstream out;
+		out << std::fixed << std::setprecision(6);
+		out << "{\"depth\":" << (iterations.empty() ? 0 : iterations.back().depth)
+			<< ",\"time\":" << time
+			<< ",\"nps\":" << nps()
+			<< ",\"branchingFactor\":" << branchingFactor()
+			<< ",\"counters\":";
+		writeCounters(out, counters);
+		out << ",\"iterations\":[";
+		for (size_t i = 0; i < iterations.size(); i++)
+		{
+			const auto& iteration = iterations[i];
+			out << (i > 0 ? "," : "")
+				<< "{\"depth\":" << iteration.depth
+				<< ",\"score\":" << iteration.score
+				<< ",\"time\":" << iteration.time
+				<< ",\"nps\":" << iteration.nps
+				<< ",\"branchingFactor\":" << iteration.branchingFactor
+				<< ",\"counters\":";
+			writeCounters(out, iteration.counters);
+			out << "}";
+		}
+		out << "]}";
+		return out.str();
+	}
+
+	std::vector<IterationStats> iterations;
+	SearchCounters counters; // totals up to the last completed iteration
+	double time = 0;
+	std::vector<long long> numaNodeNps; // whole search, all threads of each NUMA node, set when it has finished
+
+private:
+	static void writeCounters(std::ostream& out, const SearchCounters& counters)
+	{
+		out << "{\"nodes\":" << counters.nodes
+			<< ",\"ttProbes\":" << counters.ttProbes
+			<< ",\"ttHits\":" << counters.ttHits
+			<< ",\"ttStores\":" << counters.ttStores
+			<< ",\"ttReplaces\":" << counters.ttReplaces
+			<< ",\"ttHitRate\":" << counters.ttHitRate()
+			<< ",\"evalProbes\":" << counters.evalProbes
+			<< ",\"evalHits\":" << counters.evalHits
+			<< ",\"evalHitRate\":" << counters.evalHitRate()
+			<< ",\"cutoffs\":" << counters.cutoffs
+			<< ",\"firstMoveCutoffs\":" << counters.firstMoveCutoffs
+			<< ",\"firstMoveCutoffRate\":" << counters.firstMoveCutoffRate()
+			<< "}";
+	}
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <thread>
+
+// Minimal harness in the spirit of Google Benchmark. A benchmark body runs one batch
+// and returns how many operations it did; batches are repeated until minTime has
+// passed, and that measurement is repeated to report the median.
+
+inline volatile long long microbenchSink = 0;
+
+// Keeps the compiler from dropping the work whose result is only used here.
+inline void doNotOptimize(long long value)
+{
+	microbenchSink = value;
+}
+
+struct MicrobenchResult
+{
+	std::string name;
+	long long operations = 0; // per repetition
+	double realTime = 0;      // ns per operation, median of the repetitions
+	double cpuTime = 0;       // ns per operation, median of the repetitions
+	double minRealTime = 0;
+	double maxRealTime = 0;
+};
+
+class Microbench
+{
+public:
+	void add(const std::string& name, std::function<long long()> body)
+	{
+		benchmarks.push_back({ name, body });
+	}
+
+	std::vector<MicrobenchResult> run(const std::string& filter, double minTime, int repetitions)
+	{
+		std::vector<MicrobenchResult> results;
+		for (const auto& benchmark : benchmarks)
+		{
+			if (benchmark.name.find(filter) != std::string::npos)
+			{
+				results.push_back(measure(benchmark, minTime, (std::max)(1, repetitions)));
+			}
+		}
+		return results;
+	}
+
+	static void writeTable(std::ostream& out, const std::vector<MicrobenchResult>& results)
+	{
+		out << std::left << std::setw(36) << "Benchmark" << std::right << std::setw(14) << "Time (ns)"
+			<< std::setw(14) << "CPU (ns)" << std::setw(12) << "Min" << std::setw(12) << "Max" << std::setw(14) << "Operations" << "\n";
+		for (const auto& result : results)
+		{
+			out << std::left << std::setw(36) << result.name << std::right << std::fixed << std::setprecision(2)
+				<< std::setw(14) << result.realTime << std::setw(14) << result.cpuTime
+				<< std::setw(12) << result.minRealTime << std::setw(12) << result.maxRealTime
+				<< std::setw(14) << result.operations << "\n";
+		}
+	}
+
+	// Same layout as Google Benchmark's --benchmark_format=json, so the usual compare scripts work.
+	static void writeJson(std::ostream& out, const std::vector<MicrobenchResult>& results)
+	{
+		std::time_t now = std::time(nullptr);
+		char date[32];
+		std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+		out << "{\n  \"context\": {\n"
+			<< "    \"date\": \"" << date << "\",\n"
+			<< "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+			<< "    \"library_build_type\": \"release\"\n"
+#else
+			<< "    \"library_build_type\": \"debug\"\n"
+#endif
+			<< "  },\n  \"benchmarks\": [";
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const auto& result = results[i];
+			out << (i > 0 ? "," : "") << "\n    {\n"
+				<< "      \"name\": \"" << result.name << "\",\n"
+				<< "      \"run_type\": \"aggregate\",\n"
+				<< "      \"aggregate_name\": \"median\",\n"
+				<< "      \"iterations\": " << result.operations << ",\n"
+				<< std::fixed << std::setprecision(4)
+				<< "      \"real_time\": " << result.realTime << ",\n"
+				<< "      \"cpu_time\": " << result.cpuTime << ",\n"
+				<< "      \"min_real_time\": " << result.minRealTime << ",\n"
+				<< "      \"max_real_time\": " << result.maxRealTime << ",\n"
+				<< "      \"time_unit\": \"ns\"\n    }";
+		}
+		out << "\n  ]\n}\n";
+	}
+
+private:
+	struct Benchmark
+	{
+		std::string name;
+		std::function<long long()> body;
+	};
+
+	static MicrobenchResult measure(const Benchmark& benchmark, double minTime, int repetitions)
+	{
+		MicrobenchResult result;
+		result.name = benchmark.name;
+
+		benchmark.body(); // warm up
+
+		std::vector<double> realTimes, cpuTimes;
+		for (int i = 0; i < repetitions; i++)
+		{
+			long long operations = 0;
+			std::clock_t cpuStart = std::clock();
+			auto start = std::chrono::steady_clock::now();
+			double elapsed = 0;
+			while (elapsed < minTime)
+			{
+				operations += benchmark.body();
+				elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			}
+			double cpu = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+			operations = (std::max)(operations, 1LL);
+			realTimes.push_back(elapsed * 1e9 / operations);
+			cpuTimes.push_back(cpu * 1e9 / operations);
+			result.operations = operations;
+		}
+
+		result.minRealTime = *std::min_element(realTimes.begin(), realTimes.end());
+		result.maxRealTime = *std::max_element(realTimes.begin(), realTimes.end());
+		std::nth_element(realTimes.begin(), realTimes.begin() + realTimes.size() / 2, realTimes.end());
+		std::nth_element(cpuTimes.begin(), cpuTimes.begin() + cpuTimes.size() / 2, cpuTimes.end());
+		result.realTime = realTimes[realTimes.size() / 2];
+		result.cpuTime = cpuTimes[cpuTimes.size() / 2];
+		return result;
+	}
+
+	std::vector<Benchmark> benchmarks;
+};
@@ -0,0 +1,227 @@
+#include <memory>
+
+#include "Microbench.h"
+#include "Bench.h"
+
+// Microbench [--json] [--filter text] [--min-time seconds] [--repetitions n]
+//
+// Times the State primitives and the transposition table on early, mid and late
+// game positions of the bench set, and makesCircle on two crafted rings.
+
+// Black has 17 of the 18 cells of a ring around the centre, the last one is 8,7.
+const char* const ringOpen = "10,10 11,10 10,11 10,9 11,11 9,11 12,10 9,9 12,11 9,10 12,12 10,12 13,10 8,9 12,9 10,8 11,8 13,9 10,7 11,9 11,7 14,10 12,8 11,12 10,13 9,8 11,13 8,10 9,13 9,12 9,7 12,13 7,9 8,11 8,13 14,9 8,8 11,6 7,10 14,8 8,12 13,11 7,11";
+
+struct Position
+{
+	std::string name;
+	std::unique_ptr<State> state;
+	std::vector<Location> stones;
+	std::vector<Location> legalMoves;
+};
+
+Position makePosition(const std::string& name, const std::string& moves)
+{
+	Position position;
+	position.name = name;
+	position.state = std::make_unique<State>();
+	playMoves(*position.state, parseMoves(moves));
+
+	for (const auto& move : position.state->moves)
+	{
+		position.stones.push_back(move.location);
+	}
+	for (const auto& freeSpot : position.state->freeSpots)
+	{
+		if (freeSpot.moveIndex > 0)
+		{
+			position.legalMoves.push_back(freeSpot.location);
+		}
+	}
+	return position;
+}
+
+void addPositionBenchmarks(Microbench& microbench, Position& position)
+{
+	State& state = *position.state;
+
+	microbench.add("MakeUndoMove/" + position.name, [&]()
+	{
+		for (const auto& location : position.legalMoves)
+		{
+			state.makeMove(location.x, location.y);
+			state.undoMove();
+		}
+		return (long long)position.legalMoves.size();
+	});
+
+	microbench.add("PartOfStraight/" + position.name, [&]()
+	{
+		long long sum = 0;
+		for (const auto& location : position.stones)
+		{
+			sum += state.partOfStraight(location);
+		}
+		doNotOptimize(sum);
+		return (long long)position.stones.size();
+	});
+
+	microbench.add("LocationBlockingStraith/" + position.name, [&]()
+	{
+		long long sum = 0;
+		for (const auto& location : position.stones)
+		{
+			sum += state.locationBlockingStraith(location);
+		}
+		doNotOptimize(sum);
+		return (long long)position.stones.size();
+	});
+
+	microbench.add("MakesCircle/" + position.name, [&]()
+	{
+		long long sum = 0;
+		for (const auto& location : position.stones)
+		{
+			sum += state.makesCircle(location);
+		}
+		doNotOptimize(sum);
+		return (long long)position.stones.size();
+	});
+
+	microbench.add("Evaluate/" + position.name, [&]()
+	{
+		long long sum = 0;
+		for (int i = 0; i < 256; i++)
+		{
+			sum += state.evaluate();
+		}
+		doNotOptimize(sum);
+		return 256LL;
+	});
+
+	microbench.add("IsFreeSpot/" + position.name, [&]()
+	{
+		long long sum = 0;
+		for (int x = 0; x < XSIZE; x++)
+		{
+			for (int y = 0; y < YSIZE; y++)
+			{
+				sum += state.isFreeSpot(x, y);
+			}
+		}
+		doNotOptimize(sum);
+		return (long long)(XSIZE * YSIZE);
+	});
+}
+
+// Probes and stores use the hashes of the positions one and two plies below the
+// root, half of the probes hit a table filled with the one ply positions.
+void addTableBenchmarks(Microbench& microbench, Position& position, std::shared_ptr<TranspositionTable> table, std::shared_ptr<std::vector<StateHash>> hashes)
+{
+	State& state = *position.state;
+	for (const auto& first : position.legalMoves)
+	{
+		state.makeMove(first.x, first.y);
+		hashes->push_back(state.stateHash);
+		table->store(state.stateHash, StateTreeResult(0));
+		for (int i = 0; i < (int)state.freeSpots.size(); i++)
+		{
+			if (state.freeSpots[i].moveIndex > 0 && hashes->size() < 2 * position.legalMoves.size())
+			{
+				state.makeMove(state.freeSpots[i].location.x, state.freeSpots[i].location.y);
+				hashes->push_back(state.stateHash);
+				state.undoMove();
+			}
+		}
+		state.undoMove();
+	}
+
+	microbench.add("TableProbe/" + position.name, [table, hashes]()
+	{
+		long long hits = 0;
+		StateTreeResult result(0);
+		for (const auto& hash : *hashes)
+		{
+			hits += table->probe(hash, result);
+		}
+		doNotOptimize(hits);
+		return (long long)hashes->size();
+	});
+
+	// Stores into a table of its own, after the first batch every store finds its position.
+	auto stores = std::make_shared<TranspositionTable>(16);
+	microbench.add("TableStore/" + position.name, [stores, hashes]()
+	{
+		for (const auto& hash : *hashes)
+		{
+			stores->store(hash, StateTreeResult(0));
+		}
+		return (long long)hashes->size();
+	});
+}
+
+int main(int argc, char** argv)
+{
+	bool json = false;
+	std::string filter;
+	double minTime = 0.2;
+	int repetitions = 5;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+		if (option == "--json") json = true;
+		else if (option == "--filter" && i + 1 < argc) filter = argv[++i];
+		else if (option == "--min-time" && i + 1 < argc) minTime = std::stod(argv[++i]);
+		else if (option == "--repetitions" && i + 1 < argc) repetitions = std::stoi(argv[++i]);
+		else
+		{
+			std::cout << "Usage: Microbench [--json] [--filter text] [--min-time seconds] [--repetitions n]\n";
+			return 1;
+		}
+	}
+
+	std::vector<Position> positions;
+	positions.push_back(makePosition("early", benchPositions[5]));
+	positions.push_back(makePosition("mid", benchPositions[25]));
+	positions.push_back(makePosition("late", benchPositions[49]));
+
+	Microbench microbench;
+	for (auto& position : positions)
+	{
+		addPositionBenchmarks(microbench, position);
+	}
+	for (auto& position : positions)
+	{
+		addTableBenchmarks(microbench, position, std::make_shared<TranspositionTable>(16), std::make_shared<std::vector<StateHash>>());
+	}
+
+	// Walks around a 17 stone chain without closing it, and the closed ring including the flood fill.
+	Position open = makePosition("ring open", ringOpen);
+	Position closed = makePosition("ring closed", std::string(ringOpen) + " 13,8 8,7");
+	microbench.add("MakesCircle/ring open", [&]()
+	{
+		long long sum = 0;
+		for (const auto& location : open.stones)
+		{
+			sum += open.state->makesCircle(location);
+		}
+		doNotOptimize(sum);
+		return (long long)open.stones.size();
+	});
+	microbench.add("MakesCircle/ring closing move", [&]()
+	{
+		doNotOptimize(closed.state->makesCircle({ 8, 7 }));
+		return 1LL;
+	});
+
+	auto results = microbench.run(filter, minTime, repetitions);
+	if (json)
+	{
+		Microbench::writeJson(std::cout, results);
+	}
+	else
+	{
+		Microbench::writeTable(std::cout, results);
+	}
+	return 0;
+}
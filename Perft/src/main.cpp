@@ -0,0 +1,114 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+
+#include "Perft.h"
+#include "Notation.h"
+
+// Perft <depth> [threads] [moves]     counts leaf nodes, split per root move
+// Perft verify [threads]              checks every reference count
+
+int runPerft(const std::vector<Location>& moves, int depth, int threads)
+{
+	auto start = std::chrono::steady_clock::now();
+	auto divide = perftDivide(moves, depth, threads);
+	auto end = std::chrono::steady_clock::now();
+
+	unsigned long long total = 0;
+	for (const auto& entry : divide)
+	{
+		std::cout << entry.location.x << "," << entry.location.y << ": " << entry.nodes << "\n";
+		total += entry.nodes;
+	}
+
+	long long time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+	std::cout << "\nNodes: " << total
+		<< "\nTime: " << time << "ms"
+		<< "\nNodes/s: " << (long long)(total * 1000.0 / (time > 0 ? time : 1)) << "\n";
+
+	return 0;
+}
+
+int runVerify(int threads)
+{
+	int failed = 0;
+	unsigned long long totalNodes = 0;
+	auto start = std::chrono::steady_clock::now();
+
+	for (const auto& reference : perftReferences)
+	{
+		auto divide = perftDivide(parseMoves(reference.moves), reference.depth, threads);
+
+		unsigned long long nodes = 0;
+		for (const auto& entry : divide)
+		{
+			nodes += entry.nodes;
+		}
+		totalNodes += nodes;
+
+		bool ok = nodes == reference.nodes;
+		if (!ok)
+		{
+			failed++;
+		}
+
+		std::cout << (ok ? "ok     " : "FAILED ") << reference.name << " depth " << reference.depth
+			<< ": " << nodes;
+		if (!ok)
+		{
+			std::cout << " (expected " << reference.nodes << ")";
+		}
+		std::cout << "\n";
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	long long time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+	std::cout << "\n" << (failed == 0 ? "All reference counts match" : std::to_string(failed) + " reference counts differ")
+		<< "\nNodes: " << totalNodes
+		<< "\nTime: " << time << "ms"
+		<< "\nNodes/s: " << (long long)(totalNodes * 1000.0 / (time > 0 ? time : 1)) << "\n";
+
+	return failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: Perft <depth> [threads] [x,y ... | notation]\n"
+			<< "       Perft verify [threads]\n";
+		return 1;
+	}
+
+	try
+	{
+		std::string command = argv[1];
+		int threads = argc > 2 ? std::stoi(argv[2]) : (int)std::thread::hardware_concurrency();
+		if (threads < 1)
+		{
+			threads = 1;
+		}
+
+		if (command == "verify")
+		{
+			return runVerify(threads);
+		}
+
+		std::string moves;
+		for (int i = 3; i < argc; i++)
+		{
+			moves += std::string(argv[i]) + " ";
+		}
+		if (argc <= 3)
+		{
+			moves = "10,10";
+		}
+
+		return runPerft(parsePosition(moves), std::stoi(command), threads);
+	}
+	catch (const std::exception& e)
+	{
+		std::cout << e.what() << "\n";
+		return 1;
+	}
+}
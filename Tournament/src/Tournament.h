@@ -0,0 +1,270 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cmath>
+#include <mutex>
+
+#include "SearchControl.h"
+#include "Notation.h"
+
+struct EngineConfig
+{
+	SearchLimits limits;
+	int hash = 16;
+	int threads = 1;
+};
+
+struct TournamentConfig
+{
+	EngineConfig engines[2];
+	int concurrency = 1;
+	int maxGames = 1000;
+	int maxPlies = 200;
+
+	double elo0 = 0;
+	double elo1 = 5;
+	double alpha = 0.05;
+	double beta = 0.05;
+
+	std::vector<std::vector<Location>> openings;
+};
+
+// Results from the point of view of the first engine.
+struct TournamentScore
+{
+	int wins = 0;
+	int draws = 0;
+	int losses = 0;
+
+	int games() const
+	{
+		return wins + draws + losses;
+	}
+	double score() const
+	{
+		return games() > 0 ? (wins + 0.5 * draws) / games() : 0.5;
+	}
+	// Per game variance of the score.
+	double variance() const
+	{
+		if (games() == 0)
+		{
+			return 0;
+		}
+		double s = score();
+		return (wins * (1 - s) * (1 - s) + draws * (0.5 - s) * (0.5 - s) + losses * s * s) / games();
+	}
+
+	static double toElo(double score)
+	{
+		score = (std::min)((std::max)(score, 1e-6), 1 - 1e-6);
+		return -400 * std::log10(1 / score - 1);
+	}
+	static double toScore(double elo)
+	{
+		return 1 / (1 + std::pow(10, -elo / 400));
+	}
+
+	double elo() const
+	{
+		return toElo(score());
+	}
+	// No wins or no losses and draws: every interval on the score reaches 0 or 1, which is
+	// an infinite Elo difference.
+	bool eloErrorKnown() const
+	{
+		return games() > 0 && wins + draws > 0 && losses + draws > 0;
+	}
+	// Half width of the 95% confidence interval, a Wilson interval on the score with the
+	// variance of the trinomial results so it stays inside 0 to 1. Only when eloErrorKnown.
+	double eloError() const
+	{
+		const double z = 1.96;
+		double n = games();
+		double centre = (score() + z * z / (2 * n)) / (1 + z * z / n);
+		double halfWidth = z / (1 + z * z / n) * std::sqrt(variance() / n + z * z / (4 * n * n));
+		return (toElo(centre + halfWidth) - toElo(centre - halfWidth)) / 2;
+	}
+
+	// Log likelihood ratio of elo1 against elo0, normal approximation of the trinomial model.
+	double llr(double elo0, double elo1) const
+	{
+		double v = variance();
+		if (games() == 0 || v <= 0)
+		{
+			return 0;
+		}
+		double s0 = toScore(elo0);
+		double s1 = toScore(elo1);
+		return games() * (s1 - s0) * (2 * score() - s0 - s1) / (2 * v);
+	}
+};
+
+// Openings as in the old simulate(): the centre and four random moves.
+inline std::vector<std::vector<Location>> randomOpenings(int amount, unsigned int seed)
+{
+	std::vector<std::vector<Location>> openings;
+	for (const auto& position : randomPositions(amount, 5, 5, seed))
+	{
+		openings.push_back(parseNotation(position));
+	}
+	return openings;
+}
+
+// One position per line in either notation, empty lines and lines starting with # are skipped.
+inline std::vector<std::vector<Location>> readOpenings(const std::string& fileName)
+{
+	std::ifstream file(fileName);
+	if (!file)
+	{
+		throw std::invalid_argument("Cannot open " + fileName);
+	}
+
+	std::vector<std::vector<Location>> openings;
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+
+		State state;
+		auto opening = parsePosition(line);
+		playMoves(state, opening);
+		openings.push_back(opening);
+	}
+
+	return openings;
+}
+
+// Plays games between two engine configurations on several threads until
+// maxGames are played or the SPRT accepts either hypothesis. Every opening is
+// played twice with colours reversed. The score is the one the SPRT decided on,
+// the final report and run() leave out the games that finished after it.
+class Tournament
+{
+public:
+	Tournament(const TournamentConfig& _config)
+		: config(_config)
+	{
+		lowerBound = std::log(config.beta / (1 - config.alpha));
+		upperBound = std::log((1 - config.beta) / config.alpha);
+	}
+
+	TournamentScore run()
+	{
+		start = std::chrono::steady_clock::now();
+
+		std::vector<std::thread> workers;
+		for (int i = 0; i < config.concurrency; i++)
+		{
+			workers.emplace_back(&Tournament::workerFunction, this);
+		}
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		report(std::cout, true);
+		return score;
+	}
+
+private:
+	void workerFunction()
+	{
+		TranspositionTable tables[2] = { TranspositionTable(config.engines[0].hash, true, config.engines[0].threads), TranspositionTable(config.engines[1].hash, true, config.engines[1].threads) };
+
+		for (int game = nextGame++; game < config.maxGames && !finished; game = nextGame++)
+		{
+			tables[0].clear();
+			tables[1].clear();
+
+			const auto& opening = config.openings[(game / 2) % config.openings.size()];
+			int firstEngine = game % 2;
+			Player winner = playGame(opening, firstEngine, tables);
+
+			std::lock_guard<std::mutex> lock(mutex);
+			// Games that were still running when the SPRT decided do not count.
+			if (finished)
+			{
+				break;
+			}
+			if (winner == Player::Empty) score.draws++;
+			else if ((winner == Player::P1) == (firstEngine == 0)) score.wins++;
+			else score.losses++;
+
+			double llr = score.llr(config.elo0, config.elo1);
+			if (llr <= lowerBound || llr >= upperBound)
+			{
+				decision = llr >= upperBound ? 1 : -1;
+				finished = true;
+			}
+			report(std::cout, false);
+		}
+	}
+
+	// firstEngine plays Black (P1). Returns Player::Empty for a draw.
+	Player playGame(const std::vector<Location>& opening, int firstEngine, TranspositionTable* tables)
+	{
+		State state;
+		playMoves(state, opening);
+
+		int plies = 0;
+		while (!state.isEndGame() && plies < config.maxPlies)
+		{
+			int engine = state.player == Player::P1 ? firstEngine : 1 - firstEngine;
+			const EngineConfig& engineConfig = config.engines[engine];
+
+			SearchControl searchControl(state, tables[engine], engineConfig.limits, engineConfig.threads);
+			auto result = searchControl.waitForResult();
+			if (result.move < 0)
+			{
+				return Player::Empty;
+			}
+
+			state.makeMove(result.moveLocation.x, result.moveLocation.y);
+			plies++;
+		}
+
+		return state.isEndGame() ? getOtherPlayer(state.player) : Player::Empty;
+	}
+
+	void report(std::ostream& out, bool final)
+	{
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		double llr = score.llr(config.elo0, config.elo1);
+
+		out << std::fixed << std::setprecision(2)
+			<< (final ? "Final  " : "Game ") << score.games()
+			<< ":  +" << score.wins << " =" << score.draws << " -" << score.losses
+			<< "  Elo: " << score.elo() << " +/- ";
+		if (score.eloErrorKnown()) out << score.eloError();
+		else out << "n/a";
+		out
+			<< "  LLR: " << llr << " [" << lowerBound << ", " << upperBound << "]"
+			<< "  Games/s: " << score.games() / (seconds > 0 ? seconds : 1) << "\n";
+
+		if (final)
+		{
+			if (decision > 0) out << "H1 accepted: elo >= " << config.elo1 << "\n";
+			else if (decision < 0) out << "H0 accepted: elo <= " << config.elo0 << "\n";
+			else out << "No decision\n";
+		}
+	}
+
+	TournamentConfig config;
+	double lowerBound;
+	double upperBound;
+
+	std::chrono::steady_clock::time_point start;
+	std::atomic<int> nextGame{ 0 };
+	std::atomic<bool> finished{ false };
+
+	std::mutex mutex;
+	TournamentScore score; // frozen once the SPRT has decided
+	int decision = 0; // 1 for H1, -1 for H0
+};
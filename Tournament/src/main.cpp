@@ -0,0 +1,100 @@
+#include <iostream>
+#include <string>
+
+#include "Tournament.h"
+
+// Tournament [options]
+//   --engine1 <key=value,...>   time (ms per move), depth, nodes, hash (MB), threads
+//   --engine2 <key=value,...>   same for the second engine
+//   --games <n>                 maximum amount of games (1000)
+//   --concurrency <n>           games played at the same time (hardware threads)
+//   --openings <file>           one position per line, x,y list or notation
+//   --random-openings <n>       n random openings instead (100)
+//   --seed <n>                  seed for the random openings (1)
+//   --max-plies <n>             a game is a draw after this many plies (200)
+//   --elo0 <x> --elo1 <x>       SPRT hypotheses (0, 5)
+//   --alpha <x> --beta <x>      SPRT error rates (0.05, 0.05)
+
+EngineConfig parseEngine(const std::string& text)
+{
+	EngineConfig engine;
+	engine.limits.maxTime = 100;
+	engine.limits.maxDepth = 20;
+
+	std::istringstream stream(text);
+	std::string pair;
+	while (std::getline(stream, pair, ','))
+	{
+		auto split = pair.find('=');
+		if (split == std::string::npos)
+		{
+			throw std::invalid_argument("Invalid engine option: " + pair);
+		}
+
+		std::string key = pair.substr(0, split);
+		long long value = std::stoll(pair.substr(split + 1));
+
+		if (key == "time") engine.limits.maxTime = (int)value;
+		else if (key == "depth") engine.limits.maxDepth = (int)value;
+		else if (key == "nodes") engine.limits.maxNodes = value;
+		else if (key == "hash") engine.hash = (int)value;
+		else if (key == "threads") engine.threads = (int)value;
+		else throw std::invalid_argument("Unknown engine option: " + key);
+	}
+
+	return engine;
+}
+
+int main(int argc, char** argv)
+{
+	try
+	{
+		TournamentConfig config;
+		config.engines[0] = parseEngine("");
+		config.engines[1] = parseEngine("");
+		config.concurrency = (std::max)(1, (int)std::thread::hardware_concurrency());
+
+		std::string openingsFile;
+		int randomAmount = 100;
+		unsigned int seed = 1;
+
+		for (int i = 1; i < argc; i++)
+		{
+			std::string option = argv[i];
+			if (i + 1 >= argc)
+			{
+				throw std::invalid_argument("Missing value for " + option);
+			}
+			std::string value = argv[++i];
+
+			if (option == "--engine1") config.engines[0] = parseEngine(value);
+			else if (option == "--engine2") config.engines[1] = parseEngine(value);
+			else if (option == "--games") config.maxGames = std::stoi(value);
+			else if (option == "--concurrency") config.concurrency = (std::max)(1, std::stoi(value));
+			else if (option == "--openings") openingsFile = value;
+			else if (option == "--random-openings") randomAmount = std::stoi(value);
+			else if (option == "--seed") seed = (unsigned int)std::stoul(value);
+			else if (option == "--max-plies") config.maxPlies = std::stoi(value);
+			else if (option == "--elo0") config.elo0 = std::stod(value);
+			else if (option == "--elo1") config.elo1 = std::stod(value);
+			else if (option == "--alpha") config.alpha = std::stod(value);
+			else if (option == "--beta") config.beta = std::stod(value);
+			else throw std::invalid_argument("Unknown option: " + option);
+		}
+
+		config.openings = openingsFile.empty() ? randomOpenings(randomAmount, seed) : readOpenings(openingsFile);
+		if (config.openings.empty())
+		{
+			throw std::invalid_argument("No openings");
+		}
+
+		Tournament tournament(config);
+		tournament.run();
+		return 0;
+	}
+	catch (const std::exception& e)
+	{
+		std::cout << e.what() << "\n";
+		return 1;
+	}
+}